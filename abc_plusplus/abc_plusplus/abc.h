@@ -1,19 +1,53 @@
 /*
-Typedefs to avoid typing the long templates.
+Typedefs to avoid typing the long templates. Scalar is the storage type of the dataset and of the membership weights,
+Metric is one of the distance metric policies from distances.h.
 */
 #pragma once
 
 #include "colonies.h"
+#include "async_colony.h"
 #include "problems.h"
+#include "sweep.h"
+#include "restarts.h"
+#include "tuning.h"
+#include "ground_truth.h"
 
-template <size_t dim>
-using ABCFuzzyClustering = ArtificialBeeColony<FuzzyClustering<dim>, ClassicMixingStrategy<FuzzyClustering<dim>>, RouletteSelectionStrategy, std::mt19937_64>;
+template <size_t dim, typename Scalar = double, typename Metric = EuclideanMetric>
+using ABCFuzzyClustering = ArtificialBeeColony<FuzzyClustering<dim, Scalar, Metric>, ClassicMixingStrategy<FuzzyClustering<dim, Scalar, Metric>>, RouletteSelectionStrategy, std::mt19937_64>;
 
-template <size_t dim>
-using ModABCFuzzyClustering = ArtificialBeeColony<FuzzyClustering<dim>, DEMixingStrategy<FuzzyClustering<dim>>, RouletteSelectionStrategy, std::mt19937_64>;
+template <size_t dim, typename Scalar = double, typename Metric = EuclideanMetric>
+using ModABCFuzzyClustering = ArtificialBeeColony<FuzzyClustering<dim, Scalar, Metric>, DEMixingStrategy<FuzzyClustering<dim, Scalar, Metric>>, RouletteSelectionStrategy, std::mt19937_64>;
 
-template <size_t dim>
-using TournamentABCFuzzyClustering = ArtificialBeeColony<FuzzyClustering<dim>, ClassicMixingStrategy<FuzzyClustering<dim>>, TournamentSelectionStrategy, std::mt19937_64>;
+template <size_t dim, typename Scalar = double, typename Metric = EuclideanMetric>
+using TournamentABCFuzzyClustering = ArtificialBeeColony<FuzzyClustering<dim, Scalar, Metric>, ClassicMixingStrategy<FuzzyClustering<dim, Scalar, Metric>>, TournamentSelectionStrategy, std::mt19937_64>;
 
-template <size_t dim>
-using TournamentModABCFuzzyClustering = ArtificialBeeColony<FuzzyClustering<dim>, DEMixingStrategy<FuzzyClustering<dim>>, TournamentSelectionStrategy, std::mt19937_64>;
+template <size_t dim, typename Scalar = double, typename Metric = EuclideanMetric>
+using TournamentModABCFuzzyClustering = ArtificialBeeColony<FuzzyClustering<dim, Scalar, Metric>, DEMixingStrategy<FuzzyClustering<dim, Scalar, Metric>>, TournamentSelectionStrategy, std::mt19937_64>;
+
+template <size_t dim, typename Scalar = double, typename Metric = EuclideanMetric>
+using AdaptiveModABCFuzzyClustering = ArtificialBeeColony<FuzzyClustering<dim, Scalar, Metric>, AdaptiveDEMixingStrategy<FuzzyClustering<dim, Scalar, Metric>>, RouletteSelectionStrategy, std::mt19937_64>;
+
+template <size_t dim, typename Scalar = double, typename Metric = EuclideanMetric>
+using TournamentAdaptiveModABCFuzzyClustering = ArtificialBeeColony<FuzzyClustering<dim, Scalar, Metric>, AdaptiveDEMixingStrategy<FuzzyClustering<dim, Scalar, Metric>>, TournamentSelectionStrategy, std::mt19937_64>;
+
+template <size_t dim, typename Scalar = double, typename Metric = EuclideanMetric>
+using AsyncABCFuzzyClustering = AsyncArtificialBeeColony<FuzzyClustering<dim, Scalar, Metric>, ClassicMixingStrategy<FuzzyClustering<dim, Scalar, Metric>>, RouletteSelectionStrategy, std::mt19937_64>;
+
+template <size_t dim, typename Scalar = double, typename Metric = EuclideanMetric>
+using AsyncModABCFuzzyClustering = AsyncArtificialBeeColony<FuzzyClustering<dim, Scalar, Metric>, DEMixingStrategy<FuzzyClustering<dim, Scalar, Metric>>, RouletteSelectionStrategy, std::mt19937_64>;
+
+template <size_t dim, typename Scalar = double, typename Metric = EuclideanMetric>
+using AsyncAdaptiveModABCFuzzyClustering = AsyncArtificialBeeColony<FuzzyClustering<dim, Scalar, Metric>, AdaptiveDEMixingStrategy<FuzzyClustering<dim, Scalar, Metric>>, RouletteSelectionStrategy, std::mt19937_64>;
+
+
+template <size_t dim, typename Scalar = double, typename Metric = SquaredEuclideanMetric>
+using CentroidABCFuzzyClustering = ArtificialBeeColony<CentroidFuzzyClustering<dim, Scalar, Metric>, ClassicMixingStrategy<CentroidFuzzyClustering<dim, Scalar, Metric>>, RouletteSelectionStrategy, std::mt19937_64>;
+
+template <size_t dim, typename Scalar = double, typename Metric = SquaredEuclideanMetric>
+using CentroidModABCFuzzyClustering = ArtificialBeeColony<CentroidFuzzyClustering<dim, Scalar, Metric>, DEMixingStrategy<CentroidFuzzyClustering<dim, Scalar, Metric>>, RouletteSelectionStrategy, std::mt19937_64>;
+
+template <size_t dim, typename Scalar = double, typename Metric = EuclideanMetric>
+using SparseABCFuzzyClustering = ArtificialBeeColony<SparseFuzzyClustering<dim, Scalar, Metric>, ClassicMixingStrategy<SparseFuzzyClustering<dim, Scalar, Metric>>, RouletteSelectionStrategy, std::mt19937_64>;
+
+template <size_t dim, typename Scalar = double, typename Metric = EuclideanMetric>
+using SparseModABCFuzzyClustering = ArtificialBeeColony<SparseFuzzyClustering<dim, Scalar, Metric>, DEMixingStrategy<SparseFuzzyClustering<dim, Scalar, Metric>>, RouletteSelectionStrategy, std::mt19937_64>;
@@ -2,7 +2,9 @@
 Python bindings. Every specialization needs to be its own Python type, defined separately along with all of its methods.
 
 The Python API only allows clustering of vectors of specific dimensionality. This dimensionality is specified by the VECTOR_DIM
-preprocessor macro and defaults to 2.
+preprocessor macro and defaults to 2. The VECTOR_SCALAR macro selects the storage type of the data and the membership weights
+(double by default, float halves the memory use) and the VECTOR_METRIC macro selects the distance metric policy
+(EuclideanMetric by default, see distances.h).
 */
 
 #define PY_SSIZE_T_CLEAN
@@ -11,6 +13,10 @@ preprocessor macro and defaults to 2.
 #include <random>
 #include <vector>
 #include <array>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <cstdint>
 
 #include "abc.h"
 
@@ -18,11 +24,21 @@ preprocessor macro and defaults to 2.
 #define VECTOR_DIM static_cast<size_t>(2)
 #endif
 
+#ifndef VECTOR_SCALAR
+#define VECTOR_SCALAR double
+#endif
+
+#ifndef VECTOR_METRIC
+#define VECTOR_METRIC EuclideanMetric
+#endif
+
+using Vector = std::array<VECTOR_SCALAR, VECTOR_DIM>;
+
 
 struct BeeColony {
 	PyObject_HEAD
-	ABCFuzzyClustering<VECTOR_DIM>* colony_impl;
-	std::vector<std::array<double, VECTOR_DIM>>* vectors;
+	ABCFuzzyClustering<VECTOR_DIM, VECTOR_SCALAR, VECTOR_METRIC>* colony_impl;
+	std::vector<Vector>* vectors;
 };
 
 static PyTypeObject BeeColonyType = {
@@ -31,8 +47,8 @@ static PyTypeObject BeeColonyType = {
 
 struct ModBeeColony {
 	PyObject_HEAD
-	ModABCFuzzyClustering<VECTOR_DIM>* colony_impl;
-	std::vector<std::array<double, VECTOR_DIM>>* vectors;
+	ModABCFuzzyClustering<VECTOR_DIM, VECTOR_SCALAR, VECTOR_METRIC>* colony_impl;
+	std::vector<Vector>* vectors;
 };
 
 static PyTypeObject ModBeeColonyType = {
@@ -41,8 +57,8 @@ static PyTypeObject ModBeeColonyType = {
 
 struct TournamentBeeColony {
 	PyObject_HEAD
-	TournamentABCFuzzyClustering<VECTOR_DIM>* colony_impl;
-	std::vector<std::array<double, VECTOR_DIM>>* vectors;
+	TournamentABCFuzzyClustering<VECTOR_DIM, VECTOR_SCALAR, VECTOR_METRIC>* colony_impl;
+	std::vector<Vector>* vectors;
 };
 
 static PyTypeObject TournamentBeeColonyType = {
@@ -51,8 +67,8 @@ static PyTypeObject TournamentBeeColonyType = {
 
 struct TournamentModBeeColony {
 	PyObject_HEAD
-	TournamentModABCFuzzyClustering<VECTOR_DIM>* colony_impl;
-	std::vector<std::array<double, VECTOR_DIM>>* vectors;
+	TournamentModABCFuzzyClustering<VECTOR_DIM, VECTOR_SCALAR, VECTOR_METRIC>* colony_impl;
+	std::vector<Vector>* vectors;
 };
 
 static PyTypeObject TournamentModBeeColonyType = {
@@ -60,17 +76,852 @@ static PyTypeObject TournamentModBeeColonyType = {
 };
 
 
-static PyMethodDef ABCMethods[] = {
-	{NULL, NULL, 0, NULL}
-};
+/*
+The NUMA placement of the datasets of colonies created from Python, see numa.h. Changing it does not affect existing
+colonies.
+*/
+static NumaPlacement numa_placement = NumaPlacement::none;
+
+static PyObject* sweep_clusters(PyObject* module, PyObject* args);
+static PyObject* restart_colonies(PyObject* module, PyObject* args);
+static PyObject* tune_colonies(PyObject* module, PyObject* args);
+static PyObject* read_partition_file(PyObject* module, PyObject* args);
+static PyObject* set_numa(PyObject* module, PyObject* args);
+static PyObject* set_num_threads(PyObject* module, PyObject* args);
+static PyObject* get_num_threads(PyObject* module, PyObject* args);
+
+static PyMethodDef ABCMethods[] = {
+	{"sweep_clusters", (PyCFunction)sweep_clusters, METH_VARARGS,
+	 "Runs a colony for every number of clusters in a range, seeding each one with the previous solution, and returns the fitness and validity indices for every k"
+	},
+	{"restart_colonies", (PyCFunction)restart_colonies, METH_VARARGS,
+	 "Runs independent colonies with consecutive seeds in parallel, cancelling dominated ones, and returns the best colony and the results of every run"
+	},
+	{"tune_colonies", (PyCFunction)tune_colonies, METH_VARARGS,
+	 "Tunes the population, limit, f and mr of a ModArtificialBeeColony by successive halving and returns the winning colony, its configuration and the results of every configuration"
+	},
+	{"read_partition", (PyCFunction)read_partition_file, METH_VARARGS,
+	 "Reads the 0-based labels of a .pa partition file"
+	},
+	{"set_numa", (PyCFunction)set_numa, METH_VARARGS,
+	 "Sets how the datasets of colonies created afterwards are placed on NUMA nodes and whether worker threads are pinned to CPUs"
+	},
+	{"set_num_threads", (PyCFunction)set_num_threads, METH_VARARGS,
+	 "Sets the number of threads of the thread pool shared by all colonies"
+	},
+	{"get_num_threads", (PyCFunction)get_num_threads, METH_NOARGS,
+	 "Returns the number of threads of the thread pool shared by all colonies"
+	},
+	{NULL, NULL, 0, NULL}
+};
+
+static struct PyModuleDef abcmodule = {
+	PyModuleDef_HEAD_INIT,
+	"abc_plusplus",
+	"Artificial Bee Colony bindings",
+	-1,
+	ABCMethods
+};
+
+static PyObject* PhaseStats_to_dict(const PhaseStats& stats) {
+	return Py_BuildValue("{s:K,s:K,s:K,s:K,s:K,s:K}",
+		"evaluations", (unsigned long long)stats.evaluations,
+		"accepted", (unsigned long long)stats.accepted,
+		"rejected", (unsigned long long)stats.rejected,
+		"mixing_ns", (unsigned long long)stats.mixing_ns,
+		"evaluation_ns", (unsigned long long)stats.evaluation_ns,
+		"selection_ns", (unsigned long long)stats.selection_ns);
+}
+
+/*
+Methods shared by all colony types. They only rely on the colony_impl and vectors members, so a single template
+is instantiated for every Python type.
+*/
+template <typename ColonyObject>
+static PyObject* Colony_stats(ColonyObject* self, PyObject* args) {
+	const ColonyStats& stats = self->colony_impl->get_stats();
+
+	PyObject* abandonments = PyList_New(stats.abandonments.size());
+	if (abandonments == nullptr) {
+		return nullptr;
+	}
+
+	for (size_t cycle = 0; cycle < stats.abandonments.size(); ++cycle) {
+		PyObject* value = PyLong_FromUnsignedLongLong(stats.abandonments[cycle]);
+		if (value == nullptr) {
+			Py_DECREF(abandonments);
+			return nullptr;
+		}
+
+		PyList_SetItem(abandonments, cycle, value);
+	}
+
+	return Py_BuildValue("{s:O,s:K,s:K,s:N,s:N,s:N,s:N,s:N}",
+		"enabled", stats_enabled ? Py_True : Py_False,
+		"cycles", (unsigned long long)stats.cycles,
+		"champion_updates", (unsigned long long)stats.champion_updates,
+		"employed", PhaseStats_to_dict(stats.employed),
+		"onlooker", PhaseStats_to_dict(stats.onlooker),
+		"scout", PhaseStats_to_dict(stats.scout),
+		"refinement", PhaseStats_to_dict(stats.refinement),
+		"abandonments", abandonments);
+}
+
+template <typename ColonyObject>
+static PyObject* Colony_reset_stats(ColonyObject* self, PyObject* args) {
+	self->colony_impl->reset_stats();
+
+	Py_RETURN_NONE;
+}
+
+/*
+Pickling stores the dataset, the number of clusters, the mixing strategy parameters and a binary checkpoint of the
+colony. The strategy factories below translate between the strategies and the stored parameters.
+*/
+template <typename MixingStrategy>
+struct MixingStrategyFactory;
+
+template <typename ProblemType>
+struct MixingStrategyFactory<ClassicMixingStrategy<ProblemType>> {
+	static std::pair<double, double> parameters(const ClassicMixingStrategy<ProblemType>&) {
+		return { 0.0, 0.0 };
+	}
+
+	static ClassicMixingStrategy<ProblemType> make(double, double) {
+		return ClassicMixingStrategy<ProblemType>();
+	}
+};
+
+template <typename ProblemType>
+struct MixingStrategyFactory<DEMixingStrategy<ProblemType>> {
+	static std::pair<double, double> parameters(const DEMixingStrategy<ProblemType>& strategy) {
+		return { strategy.get_f(), strategy.get_mr() };
+	}
+
+	static DEMixingStrategy<ProblemType> make(double f, double mr) {
+		return DEMixingStrategy<ProblemType>(f, mr);
+	}
+};
+
+//reads an n by VECTOR_DIM sequence of numbers, setting a Python exception on failure
+static bool parse_vectors(PyObject* sequence, std::vector<Vector>& vectors) {
+	if (!PySequence_Check(sequence)) {
+		PyErr_SetString(PyExc_TypeError, "expected a sequence of vectors");
+		return false;
+	}
+
+	Py_ssize_t n_vectors = PySequence_Size(sequence);
+	vectors.resize(n_vectors);
+	for (Py_ssize_t vector_idx = 0; vector_idx < n_vectors; ++vector_idx) {
+		PyObject* vector = PySequence_GetItem(sequence, vector_idx);
+		if (vector == nullptr) {
+			return false;
+		}
+
+		if (!PySequence_Check(vector) || PySequence_Size(vector) != VECTOR_DIM) {
+			Py_DECREF(vector);
+			PyErr_SetString(PyExc_ValueError, "every vector must be a sequence of VECTOR_DIM numbers");
+			return false;
+		}
+
+		for (size_t dimension = 0; dimension < VECTOR_DIM; ++dimension) {
+			PyObject* value = PySequence_GetItem(vector, dimension);
+			if (value == nullptr) {
+				Py_DECREF(vector);
+				return false;
+			}
+
+			vectors[vector_idx][dimension] = PyFloat_AsDouble(value);
+			Py_DECREF(value);
+			if (PyErr_Occurred()) {
+				Py_DECREF(vector);
+				return false;
+			}
+		}
+
+		Py_DECREF(vector);
+	}
+
+	return true;
+}
+
+static PyObject* vectors_to_list(const std::vector<Vector>& vectors) {
+	PyObject* result = PyList_New(vectors.size());
+	if (result == nullptr) {
+		return nullptr;
+	}
+
+	for (size_t vector_idx = 0; vector_idx < vectors.size(); ++vector_idx) {
+		PyObject* vector = PyList_New(VECTOR_DIM);
+		if (vector == nullptr) {
+			Py_DECREF(result);
+			return nullptr;
+		}
+		PyList_SetItem(result, vector_idx, vector);
+
+		for (size_t dimension = 0; dimension < VECTOR_DIM; ++dimension) {
+			PyObject* value = PyFloat_FromDouble(vectors[vector_idx][dimension]);
+			if (value == nullptr) {
+				Py_DECREF(result);
+				return nullptr;
+			}
+			PyList_SetItem(vector, dimension, value);
+		}
+	}
+
+	return result;
+}
+
+/*
+Reads an n by n_cols matrix either from a C-contiguous buffer of float64 or float32 (e.g. a numpy array) or from a
+sequence of sequences, setting a Python exception on failure. When n_cols is 0, it is set to the number of columns of
+the matrix.
+*/
+static bool parse_matrix(PyObject* object, size_t& n_cols, std::vector<double>& values) {
+	if (!PyObject_CheckBuffer(object)) {
+		if (!PySequence_Check(object)) {
+			PyErr_SetString(PyExc_TypeError, "expected an array or a sequence of sequences");
+			return false;
+		}
+
+		Py_ssize_t n_rows = PySequence_Size(object);
+		if (n_cols == 0 && n_rows > 0) {
+			PyObject* first_row = PySequence_GetItem(object, 0);
+			if (first_row == nullptr) {
+				return false;
+			}
+			n_cols = PySequence_Check(first_row) ? PySequence_Size(first_row) : 0;
+			Py_DECREF(first_row);
+		}
+
+		values.resize(n_rows * n_cols);
+		for (Py_ssize_t row = 0; row < n_rows; ++row) {
+			PyObject* items = PySequence_GetItem(object, row);
+			if (items == nullptr) {
+				return false;
+			}
+
+			if (!PySequence_Check(items) || PySequence_Size(items) != (Py_ssize_t)n_cols) {
+				Py_DECREF(items);
+				PyErr_Format(PyExc_ValueError, "every row must be a sequence of %zu numbers", n_cols);
+				return false;
+			}
+
+			for (size_t col = 0; col < n_cols; ++col) {
+				PyObject* value = PySequence_GetItem(items, col);
+				if (value == nullptr) {
+					Py_DECREF(items);
+					return false;
+				}
+
+				values[row * n_cols + col] = PyFloat_AsDouble(value);
+				Py_DECREF(value);
+				if (PyErr_Occurred()) {
+					Py_DECREF(items);
+					return false;
+				}
+			}
+
+			Py_DECREF(items);
+		}
+
+		return true;
+	}
+
+	Py_buffer view;
+	if (PyObject_GetBuffer(object, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) < 0) {
+		return false;
+	}
+
+	const char* format = view.format[0] == '=' || view.format[0] == '<' || view.format[0] == '@' ? view.format + 1 : view.format;
+	bool is_double = std::string(format) == "d";
+	bool is_float = std::string(format) == "f";
+	if (n_cols == 0 && view.ndim == 2) {
+		n_cols = view.shape[1];
+	}
+	if (view.ndim != 2 || view.shape[1] != (Py_ssize_t)n_cols || !(is_double || is_float)) {
+		PyBuffer_Release(&view);
+		PyErr_Format(PyExc_ValueError, "expected an n by %zu array of float64 or float32", n_cols);
+		return false;
+	}
+
+	values.resize(view.shape[0] * n_cols);
+	for (size_t value_idx = 0; value_idx < values.size(); ++value_idx) {
+		values[value_idx] = is_double ? static_cast<const double*>(view.buf)[value_idx] : static_cast<const float*>(view.buf)[value_idx];
+	}
+
+	PyBuffer_Release(&view);
+	return true;
+}
+
+//reads an n by VECTOR_DIM matrix of points, see parse_matrix
+static bool parse_points(PyObject* object, std::vector<Vector>& points) {
+	std::vector<double> values;
+	size_t n_cols = VECTOR_DIM;
+	if (!parse_matrix(object, n_cols, values)) {
+		return false;
+	}
+
+	points.resize(values.size() / VECTOR_DIM);
+	for (size_t point_idx = 0; point_idx < points.size(); ++point_idx) {
+		for (size_t dimension = 0; dimension < VECTOR_DIM; ++dimension) {
+			points[point_idx][dimension] = static_cast<VECTOR_SCALAR>(values[point_idx * VECTOR_DIM + dimension]);
+		}
+	}
+
+	return true;
+}
+
+static const char* initialization_names[] = { "uniform", "kmeans++", "opposition", "centers" };
+
+/*
+Translates the optional initialization arguments of the constructors: the name of the method ("uniform", "kmeans++",
+"opposition", "centers" or "memberships") and, for the last two, the warm start as a k by VECTOR_DIM matrix of centers
+or a k by n matrix of memberships. Sets a Python exception on failure.
+*/
+static bool parse_initialization(const char* name, PyObject* warm_start, size_t n_vectors, std::shared_ptr<const Initialization>& result) {
+	std::shared_ptr<Initialization> initialization = std::make_shared<Initialization>();
+	std::string method(name);
+
+	if (method == "uniform") {
+		initialization->method = InitializationMethod::uniform;
+	}
+	else if (method == "kmeans++") {
+		initialization->method = InitializationMethod::kmeans_plus_plus;
+	}
+	else if (method == "opposition") {
+		initialization->method = InitializationMethod::opposition;
+	}
+	else if (method == "centers" || method == "memberships") {
+		initialization->method = InitializationMethod::warm_start;
+		if (warm_start == nullptr || warm_start == Py_None) {
+			PyErr_SetString(PyExc_ValueError, "a warm start needs the centers or the memberships");
+			return false;
+		}
+
+		size_t n_cols = method == "centers" ? VECTOR_DIM : n_vectors;
+		if (!parse_matrix(warm_start, n_cols, method == "centers" ? initialization->warm_centers : initialization->warm_memberships)) {
+			return false;
+		}
+	}
+	else {
+		PyErr_SetString(PyExc_ValueError, "unknown initialization, expected one of uniform, kmeans++, opposition, centers or memberships");
+		return false;
+	}
+
+	result = initialization;
+	return true;
+}
+
+//reads 0-based labels from a path to a .pa file or from a sequence of integers
+static bool parse_labels(PyObject* object, std::vector<int64_t>& labels) {
+	if (PyUnicode_Check(object)) {
+		try {
+			labels = read_partition(PyUnicode_AsUTF8(object));
+		}
+		catch (const std::exception& e) {
+			PyErr_SetString(PyExc_OSError, e.what());
+			return false;
+		}
+		return true;
+	}
+
+	PyObject* sequence = PySequence_Fast(object, "expected a path or a sequence of labels");
+	if (sequence == nullptr) {
+		return false;
+	}
+
+	labels.resize(PySequence_Fast_GET_SIZE(sequence));
+	for (size_t label_idx = 0; label_idx < labels.size(); ++label_idx) {
+		labels[label_idx] = PyNumber_AsSsize_t(PySequence_Fast_GET_ITEM(sequence, label_idx), PyExc_OverflowError);
+		if (labels[label_idx] < 0) {
+			Py_DECREF(sequence);
+			if (!PyErr_Occurred()) {
+				PyErr_SetString(PyExc_ValueError, "labels must be non-negative");
+			}
+			return false;
+		}
+	}
+
+	Py_DECREF(sequence);
+	return true;
+}
+
+/*
+Builds the ground truth for evaluate_quality from the optional labels (see parse_labels), reference memberships (a path
+to an .npy file or an n by k matrix) and centroids (a path to a text file or a k by VECTOR_DIM matrix). Sets a Python
+exception on failure.
+*/
+static bool parse_reference(PyObject* labels, PyObject* memberships, PyObject* centroids, size_t n_vectors, ClusteringReference& reference) {
+	if (labels != nullptr && labels != Py_None) {
+		if (!parse_labels(labels, reference.labels)) {
+			return false;
+		}
+		if (reference.labels.size() != n_vectors) {
+			PyErr_Format(PyExc_ValueError, "expected %zu labels", n_vectors);
+			return false;
+		}
+	}
+
+	if (memberships != nullptr && memberships != Py_None) {
+		if (PyUnicode_Check(memberships)) {
+			try {
+				std::vector<size_t> shape;
+				reference.memberships = read_npy(PyUnicode_AsUTF8(memberships), shape);
+				reference.n_clusters = shape.size() == 2 ? shape[1] : 0;
+			}
+			catch (const std::exception& e) {
+				PyErr_SetString(PyExc_OSError, e.what());
+				return false;
+			}
+		}
+		else if (!parse_matrix(memberships, reference.n_clusters, reference.memberships)) {
+			return false;
+		}
+
+		if (reference.n_clusters == 0 || reference.memberships.size() != n_vectors * reference.n_clusters) {
+			PyErr_Format(PyExc_ValueError, "expected memberships of shape (%zu, k)", n_vectors);
+			return false;
+		}
+	}
+
+	if (centroids != nullptr && centroids != Py_None) {
+		size_t n_cols = VECTOR_DIM;
+		if (PyUnicode_Check(centroids)) {
+			try {
+				reference.centers = read_text_matrix(PyUnicode_AsUTF8(centroids), n_cols);
+			}
+			catch (const std::exception& e) {
+				PyErr_SetString(PyExc_OSError, e.what());
+				return false;
+			}
+		}
+		else if (!parse_matrix(centroids, n_cols, reference.centers)) {
+			return false;
+		}
+
+		if (n_cols != VECTOR_DIM || reference.centers.empty()) {
+			PyErr_Format(PyExc_ValueError, "expected centroids of shape (k, %zu)", (size_t)VECTOR_DIM);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//indices without a reference are None
+static PyObject* quality_to_python(const ClusteringQuality& quality) {
+	auto none = []() { Py_INCREF(Py_None); return Py_None; };
+	auto optional_float = [&none](double value) { return std::isnan(value) ? none() : PyFloat_FromDouble(value); };
+
+	return Py_BuildValue("{s:d,s:d,s:d,s:N,s:N,s:N}",
+		"partition_coefficient", quality.validity.partition_coefficient,
+		"partition_entropy", quality.validity.partition_entropy,
+		"xie_beni", quality.validity.xie_beni,
+		"adjusted_rand_index", optional_float(quality.adjusted_rand_index),
+		"fuzzy_adjusted_rand_index", optional_float(quality.fuzzy_adjusted_rand_index),
+		"centroid_index", quality.centroid_index < 0 ? none() : PyLong_FromLongLong(quality.centroid_index));
+}
+
+static PyObject* value_to_python(double value) {
+	return PyFloat_FromDouble(value);
+}
+
+static PyObject* value_to_python(int64_t value) {
+	return PyLong_FromLongLong(value);
+}
+
+/*
+Returns the values as a new numpy array of shape (rows, cols), or (rows,) when cols is 0. When numpy is not available
+a list (of lists) is returned instead.
+*/
+template <typename ValueType>
+static PyObject* values_to_array(const std::vector<ValueType>& values, size_t rows, size_t cols) {
+	PyObject* numpy = PyImport_ImportModule("numpy");
+	if (numpy == nullptr) {
+		PyErr_Clear();
+
+		PyObject* result = PyList_New(rows);
+		if (result == nullptr) {
+			return nullptr;
+		}
+
+		for (size_t row = 0; row < rows; ++row) {
+			PyObject* item = cols == 0 ? value_to_python(values[row]) : PyList_New(cols);
+			if (item == nullptr) {
+				Py_DECREF(result);
+				return nullptr;
+			}
+			PyList_SetItem(result, row, item);
+
+			for (size_t col = 0; col < cols; ++col) {
+				PyObject* value = value_to_python(values[row * cols + col]);
+				if (value == nullptr) {
+					Py_DECREF(result);
+					return nullptr;
+				}
+				PyList_SetItem(item, col, value);
+			}
+		}
+
+		return result;
+	}
+
+	const char* dtype = std::is_same_v<ValueType, double> ? "float64" : "int64";
+	PyObject* result = cols == 0 ? PyObject_CallMethod(numpy, "empty", "((n)s)", (Py_ssize_t)rows, dtype) : PyObject_CallMethod(numpy, "empty", "((nn)s)", (Py_ssize_t)rows, (Py_ssize_t)cols, dtype);
+	Py_DECREF(numpy);
+	if (result == nullptr) {
+		return nullptr;
+	}
+
+	Py_buffer view;
+	if (PyObject_GetBuffer(result, &view, PyBUF_WRITABLE | PyBUF_C_CONTIGUOUS) < 0) {
+		Py_DECREF(result);
+		return nullptr;
+	}
+	std::copy(values.cbegin(), values.cend(), static_cast<ValueType*>(view.buf));
+	PyBuffer_Release(&view);
+
+	return result;
+}
+
+template <typename ColonyObject>
+static PyObject* Colony_transform(ColonyObject* self, PyObject* args) {
+	PyObject* object;
+	double fuzzifier = 2.0;
+
+	if (!PyArg_ParseTuple(args, "O|d", &object, &fuzzifier)) {
+		return nullptr;
+	}
+
+	if (fuzzifier <= 1.0) {
+		PyErr_SetString(PyExc_ValueError, "the fuzzifier must be greater than 1");
+		return nullptr;
+	}
+
+	std::vector<Vector> points;
+	if (!parse_points(object, points)) {
+		return nullptr;
+	}
+
+	std::vector<double> memberships;
+	Py_BEGIN_ALLOW_THREADS
+	memberships = self->colony_impl->transform(points, fuzzifier);
+	Py_END_ALLOW_THREADS
+
+	return values_to_array(memberships, points.size(), self->colony_impl->get_champion().get_state().get_n_clusters());
+}
+
+template <typename ColonyObject>
+static PyObject* Colony_predict(ColonyObject* self, PyObject* args) {
+	PyObject* object;
+
+	if (!PyArg_ParseTuple(args, "O", &object)) {
+		return nullptr;
+	}
+
+	std::vector<Vector> points;
+	if (!parse_points(object, points)) {
+		return nullptr;
+	}
+
+	std::vector<int64_t> labels;
+	Py_BEGIN_ALLOW_THREADS
+	labels = self->colony_impl->predict(points);
+	Py_END_ALLOW_THREADS
+
+	return values_to_array(labels, points.size(), 0);
+}
+
+template <typename ColonyObject>
+static PyObject* Colony_append_vectors(ColonyObject* self, PyObject* args) {
+	PyObject* object;
+
+	if (!PyArg_ParseTuple(args, "O", &object)) {
+		return nullptr;
+	}
+
+	std::vector<Vector> points;
+	if (!parse_points(object, points)) {
+		return nullptr;
+	}
+
+	//the colony extends a copy of the dataset; the own vectors follow it for pickling, quality and the solutions
+	Py_BEGIN_ALLOW_THREADS
+	self->colony_impl->append_vectors(points);
+	self->vectors->insert(self->vectors->end(), points.cbegin(), points.cend());
+	Py_END_ALLOW_THREADS
+
+	Py_RETURN_NONE;
+}
+
+template <typename ColonyObject>
+static PyObject* Colony_getstate(ColonyObject* self, PyObject* args) {
+	using ColonyType = std::remove_pointer_t<decltype(self->colony_impl)>;
+	using Factory = MixingStrategyFactory<typename ColonyType::mixing_strategy_type>;
+
+	std::ostringstream checkpoint;
+	try {
+		self->colony_impl->save(checkpoint);
+	}
+	catch (const std::exception& e) {
+		PyErr_SetString(PyExc_RuntimeError, e.what());
+		return nullptr;
+	}
+
+	PyObject* vectors = vectors_to_list(*self->vectors);
+	if (vectors == nullptr) {
+		return nullptr;
+	}
+
+	//a warm start is stored through its (already derived) centers
+	const std::shared_ptr<const Initialization>& initialization = self->colony_impl->get_problem_params().initialization;
+	const char* initialization_name = initialization_names[static_cast<int>(initialization ? initialization->method : InitializationMethod::uniform)];
+	PyObject* warm_centers = PyList_New(0);
+	if (warm_centers == nullptr) {
+		Py_DECREF(vectors);
+		return nullptr;
+	}
+	if (initialization && initialization->method == InitializationMethod::warm_start) {
+		for (size_t row = 0; row < initialization->warm_centers.size() / VECTOR_DIM; ++row) {
+			PyObject* center = PyList_New(VECTOR_DIM);
+			if (center == nullptr || PyList_Append(warm_centers, center) < 0) {
+				Py_XDECREF(center);
+				Py_DECREF(warm_centers);
+				Py_DECREF(vectors);
+				return nullptr;
+			}
+			Py_DECREF(center);
+
+			for (size_t dimension = 0; dimension < VECTOR_DIM; ++dimension) {
+				PyList_SetItem(center, dimension, PyFloat_FromDouble(initialization->warm_centers[row * VECTOR_DIM + dimension]));
+			}
+		}
+	}
+
+	const auto& champion = self->colony_impl->get_champion();
+	std::pair<double, double> mixing_parameters = Factory::parameters(champion.get_mixing_strategy());
+	std::string bytes = checkpoint.str();
+	const RefinementSchedule& refinement = self->colony_impl->get_refinement();
+
+	return Py_BuildValue("(NKddy#sNKKKK)", vectors, (unsigned long long)champion.get_state().get_n_clusters(), mixing_parameters.first, mixing_parameters.second, bytes.data(), (Py_ssize_t)bytes.size(), initialization_name, warm_centers,
+		(unsigned long long)refinement.period, (unsigned long long)refinement.iterations, (unsigned long long)refinement.n_bees, (unsigned long long)self->colony_impl->get_cycles_since_refinement());
+}
+
+template <typename ColonyObject>
+static PyObject* Colony_setstate(ColonyObject* self, PyObject* state) {
+	using ColonyType = std::remove_pointer_t<decltype(self->colony_impl)>;
+	using Factory = MixingStrategyFactory<typename ColonyType::mixing_strategy_type>;
+
+	PyObject* vectors;
+	unsigned long long n_clusters;
+	double f;
+	double mr;
+	const char* bytes;
+	Py_ssize_t n_bytes;
+	const char* initialization_name = "uniform";
+	PyObject* warm_centers = nullptr;
+	RefinementSchedule refinement;
+	unsigned long long refinement_period = refinement.period, refinement_iterations = refinement.iterations, refinement_bees = refinement.n_bees, cycles_since_refinement = 0;
+
+	if (!PyArg_ParseTuple(state, "OKddy#|sOKKKK", &vectors, &n_clusters, &f, &mr, &bytes, &n_bytes, &initialization_name, &warm_centers,
+		&refinement_period, &refinement_iterations, &refinement_bees, &cycles_since_refinement)) {
+		return nullptr;
+	}
+
+	//load rejects a checkpoint whose solutions do not have n_clusters memberships for every vector
+	if (n_clusters == 0) {
+		PyErr_SetString(PyExc_ValueError, "the pickled number of clusters must be positive");
+		return nullptr;
+	}
+
+	std::vector<Vector>* parsed_vectors = new std::vector<Vector>();
+	if (!parse_vectors(vectors, *parsed_vectors)) {
+		delete parsed_vectors;
+		return nullptr;
+	}
+
+	FuzzyClusteringParams<VECTOR_DIM, VECTOR_SCALAR, VECTOR_METRIC> params;
+	params.n_clusters = n_clusters;
+	params.vectors = parsed_vectors;
+	params.placement = numa_placement;
+	if (!parse_initialization(initialization_name, warm_centers, parsed_vectors->size(), params.initialization)) {
+		delete parsed_vectors;
+		return nullptr;
+	}
+
+	ColonyType* colony;
+	try {
+		std::istringstream checkpoint(std::string(bytes, n_bytes));
+		colony = new ColonyType(ColonyType::load(checkpoint, params, Factory::make(f, mr), typename ColonyType::selection_strategy_type()));
+	}
+	catch (const std::exception& e) {
+		delete parsed_vectors;
+		PyErr_SetString(PyExc_ValueError, e.what());
+		return nullptr;
+	}
+
+	refinement.period = refinement_period;
+	refinement.iterations = refinement_iterations;
+	refinement.n_bees = refinement_bees;
+	colony->set_refinement(refinement, cycles_since_refinement);
+
+	delete self->colony_impl;
+	delete self->vectors;
+	self->colony_impl = colony;
+	self->vectors = parsed_vectors;
+
+	Py_RETURN_NONE;
+}
+
+template <typename ColonyObject>
+static PyObject* Colony_save(ColonyObject* self, PyObject* args) {
+	const char* path;
+
+	if (!PyArg_ParseTuple(args, "s", &path)) {
+		return nullptr;
+	}
+
+	try {
+		self->colony_impl->save(std::string(path));
+	}
+	catch (const std::exception& e) {
+		PyErr_SetString(PyExc_OSError, e.what());
+		return nullptr;
+	}
+
+	Py_RETURN_NONE;
+}
+
+template <typename ColonyObject>
+static PyObject* Colony_record_convergence(ColonyObject* self, PyObject* args) {
+	int enabled = 1;
+
+	if (!PyArg_ParseTuple(args, "|p", &enabled)) {
+		return nullptr;
+	}
+
+	self->colony_impl->record_convergence(enabled);
+
+	Py_RETURN_NONE;
+}
+
+template <typename ColonyObject>
+static PyObject* Colony_set_refinement(ColonyObject* self, PyObject* args) {
+	RefinementSchedule schedule;
+	unsigned long long period, iterations = schedule.iterations, n_bees = schedule.n_bees;
+
+	if (!PyArg_ParseTuple(args, "K|KK", &period, &iterations, &n_bees)) {
+		return nullptr;
+	}
+
+	schedule.period = period;
+	schedule.iterations = iterations;
+	schedule.n_bees = n_bees;
+	self->colony_impl->set_refinement(schedule);
+
+	Py_RETURN_NONE;
+}
+
+template <typename ColonyObject>
+static PyObject* Colony_quality(ColonyObject* self, PyObject* args, PyObject* kwargs) {
+	static const char* keywords[] = { "labels", "memberships", "centroids", nullptr };
+	PyObject* labels = nullptr;
+	PyObject* memberships = nullptr;
+	PyObject* centroids = nullptr;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|OOO", const_cast<char**>(keywords), &labels, &memberships, &centroids)) {
+		return nullptr;
+	}
+
+	ClusteringReference reference;
+	if (!parse_reference(labels, memberships, centroids, self->vectors->size(), reference)) {
+		return nullptr;
+	}
+
+	ClusteringQuality quality;
+	Py_BEGIN_ALLOW_THREADS
+	quality = evaluate_quality(self->colony_impl->get_champion().get_state(), *self->vectors, reference);
+	Py_END_ALLOW_THREADS
+
+	return quality_to_python(quality);
+}
+
+template <typename ColonyObject>
+static PyObject* Colony_set_monitor(ColonyObject* self, PyObject* args) {
+	unsigned long long period;
+	PyObject* callback;
+
+	if (!PyArg_ParseTuple(args, "KO", &period, &callback)) {
+		return nullptr;
+	}
+
+	if (callback == Py_None) {
+		self->colony_impl->set_monitor(0, nullptr);
+		Py_RETURN_NONE;
+	}
+
+	if (!PyCallable_Check(callback)) {
+		PyErr_SetString(PyExc_TypeError, "the monitor must be callable");
+		return nullptr;
+	}
+
+	//the colony owns a reference to the callback; self is borrowed, since the colony does not outlive it
+	Py_INCREF(callback);
+	std::shared_ptr<PyObject> reference(callback, [](PyObject* object) { Py_DECREF(object); });
+	PyObject* colony = (PyObject*)self;
+	self->colony_impl->set_monitor(period, [reference, colony](const auto&) {
+		//once the callback has raised, the remaining calls are skipped and fit reports the exception
+		if (PyErr_Occurred()) {
+			return;
+		}
+
+		Py_XDECREF(PyObject_CallFunctionObjArgs(reference.get(), colony, nullptr));
+	});
+
+	Py_RETURN_NONE;
+}
+
+template <typename ColonyObject>
+static PyObject* Colony_convergence(ColonyObject* self, PyObject* args) {
+	const std::vector<ConvergenceRecord>& records = self->colony_impl->get_convergence().get_records();
+
+	PyObject* result = PyList_New(records.size());
+	if (result == nullptr) {
+		return nullptr;
+	}
+
+	for (size_t cycle = 0; cycle < records.size(); ++cycle) {
+		PyObject* row = Py_BuildValue("[ddK]", records[cycle].champion_fitness, records[cycle].mean_fitness, (unsigned long long)records[cycle].evaluations);
+		if (row == nullptr) {
+			Py_DECREF(result);
+			return nullptr;
+		}
+
+		PyList_SetItem(result, cycle, row);
+	}
+
+	return result;
+}
+
+template <typename ColonyObject>
+static PyObject* Colony_save_convergence(ColonyObject* self, PyObject* args) {
+	const char* path;
+
+	if (!PyArg_ParseTuple(args, "s", &path)) {
+		return nullptr;
+	}
+
+	try {
+		self->colony_impl->get_convergence().write_npy(path);
+	}
+	catch (const std::exception& e) {
+		PyErr_SetString(PyExc_OSError, e.what());
+		return nullptr;
+	}
 
-static struct PyModuleDef abcmodule = {
-	PyModuleDef_HEAD_INIT,
-	"abc_plusplus",
-	"Artificial Bee Colony bindings",
-	-1,
-	ABCMethods
-};
+	Py_RETURN_NONE;
+}
 
 static PyObject* BeeColony_new(PyTypeObject* type, PyObject* args, PyObject *kwds) {
 	BeeColony* self;
@@ -90,7 +941,11 @@ static int BeeColony_init(BeeColony* self, PyObject* args) {
 	size_t n_clusters;
 	PyObject* vectors;
 
-	if (!PyArg_ParseTuple(args, "OKKK", &vectors, &n_clusters, &population, &limit)) {
+	const char* initialization_name = "uniform";
+	PyObject* warm_start = nullptr;
+	unsigned long long seed = std::mt19937_64::default_seed;
+
+	if (!PyArg_ParseTuple(args, "OKKK|sOK", &vectors, &n_clusters, &population, &limit, &initialization_name, &warm_start, &seed)) {
 		return -1;
 	}
 
@@ -98,7 +953,7 @@ static int BeeColony_init(BeeColony* self, PyObject* args) {
 		return -1;
 	}
 
-	self->vectors = new std::vector<std::array<double, VECTOR_DIM>>();
+	self->vectors = new std::vector<Vector>();
 
 	Py_ssize_t n_vectors = PySequence_Size(vectors);
 	self->vectors->resize(n_vectors);
@@ -123,10 +978,21 @@ static int BeeColony_init(BeeColony* self, PyObject* args) {
 		}
 	}
 
-	FuzzyClusteringParams<VECTOR_DIM> params;
+	FuzzyClusteringParams<VECTOR_DIM, VECTOR_SCALAR, VECTOR_METRIC> params;
 	params.n_clusters = n_clusters;
 	params.vectors = self->vectors;
-	self->colony_impl = new ABCFuzzyClustering<VECTOR_DIM>(params, population, limit, ClassicMixingStrategy<FuzzyClustering<VECTOR_DIM>>(), RouletteSelectionStrategy(), std::mt19937_64());
+	params.placement = numa_placement;
+	if (!parse_initialization(initialization_name, warm_start, self->vectors->size(), params.initialization)) {
+		return -1;
+	}
+
+	try {
+		self->colony_impl = new ABCFuzzyClustering<VECTOR_DIM, VECTOR_SCALAR, VECTOR_METRIC>(params, population, limit, ClassicMixingStrategy<FuzzyClustering<VECTOR_DIM, VECTOR_SCALAR, VECTOR_METRIC>>(), RouletteSelectionStrategy(), std::mt19937_64(seed));
+	}
+	catch (const std::exception& e) {
+		PyErr_SetString(PyExc_ValueError, e.what());
+		return -1;
+	}
 
 	return 0;
 }
@@ -144,6 +1010,10 @@ static PyObject* ABC_fit(BeeColony* self, PyObject* args) {
 	}
 
 	self->colony_impl->optimize(cycles);
+	//raised by the monitor, see Colony_set_monitor
+	if (PyErr_Occurred()) {
+		return nullptr;
+	}
 
 	Py_RETURN_NONE;
 }
@@ -153,9 +1023,13 @@ static PyObject* ABC_score(BeeColony* self, PyObject* args) {
 }
 
 static PyObject* ABC_optimize(BeeColony* self, PyObject* args) {
-	Py_DECREF(ABC_fit(self, args));
+	PyObject* fit_result = ABC_fit(self, args);
+	if (fit_result == nullptr) {
+		return nullptr;
+	}
+	Py_DECREF(fit_result);
 
-	FuzzyClustering<VECTOR_DIM> solution = self->colony_impl->get_champion().get_state();
+	FuzzyClustering<VECTOR_DIM, VECTOR_SCALAR, VECTOR_METRIC> solution = self->colony_impl->get_champion().get_state();
 	PyObject* result = PyList_New(solution.get_n_clusters());
 
 	if (result == nullptr) {
@@ -198,6 +1072,48 @@ static PyMethodDef BeeColony_methods[] = {
 	{"score", (PyCFunction)ABC_score, METH_VARARGS,
 	 "Returns the score of the best solution"
 	},
+	{"stats", (PyCFunction)Colony_stats<BeeColony>, METH_NOARGS,
+	 "Returns the performance counters collected so far (empty unless built with ABC_STATS)"
+	},
+	{"reset_stats", (PyCFunction)Colony_reset_stats<BeeColony>, METH_NOARGS,
+	 "Resets the performance counters"
+	},
+	{"record_convergence", (PyCFunction)Colony_record_convergence<BeeColony>, METH_VARARGS,
+	 "Enables (or with False disables) recording of the convergence trace in subsequent cycles"
+	},
+	{"quality", (PyCFunction)(void(*)(void))Colony_quality<BeeColony>, METH_VARARGS | METH_KEYWORDS,
+	 "Returns the validity indices of the best solution and, given the ground truth labels, memberships or centroids (arrays or paths to .pa, .npy or text files), the corresponding external indices"
+	},
+	{"set_monitor", (PyCFunction)Colony_set_monitor<BeeColony>, METH_VARARGS,
+	 "Calls the callback with the colony every period cycles; None removes it"
+	},
+	{"set_refinement", (PyCFunction)Colony_set_refinement<BeeColony>, METH_VARARGS,
+	 "Every period cycles (0 disables) refines the champion and the given number of fittest bees with fuzzy c-means iterations"
+	},
+	{"convergence", (PyCFunction)Colony_convergence<BeeColony>, METH_NOARGS,
+	 "Returns the convergence trace as a list of [champion fitness, mean fitness, evaluations] rows, one per cycle"
+	},
+	{"save_convergence", (PyCFunction)Colony_save_convergence<BeeColony>, METH_VARARGS,
+	 "Writes the convergence trace to a .npy file"
+	},
+	{"save", (PyCFunction)Colony_save<BeeColony>, METH_VARARGS,
+	 "Writes a binary checkpoint of the colony (without the dataset) to a file"
+	},
+	{"transform", (PyCFunction)Colony_transform<BeeColony>, METH_VARARGS,
+	 "Returns the fuzzy memberships of new points with respect to the clusters of the best solution"
+	},
+	{"predict", (PyCFunction)Colony_predict<BeeColony>, METH_VARARGS,
+	 "Returns the index of the nearest cluster of the best solution for every new point"
+	},
+	{"append_vectors", (PyCFunction)Colony_append_vectors<BeeColony>, METH_VARARGS,
+	 "Appends points to the dataset and extends the population to them, keeping the progress made so far"
+	},
+	{"__getstate__", (PyCFunction)Colony_getstate<BeeColony>, METH_NOARGS,
+	 "Returns the dataset, the parameters and a checkpoint of the colony, for pickling"
+	},
+	{"__setstate__", (PyCFunction)Colony_setstate<BeeColony>, METH_O,
+	 "Restores the colony from the value returned by __getstate__"
+	},
 	{NULL}
 };
 
@@ -222,7 +1138,11 @@ static int ModBeeColony_init(ModBeeColony* self, PyObject* args) {
 	size_t n_clusters;
 	PyObject* vectors;
 
-	if (!PyArg_ParseTuple(args, "OKKKdd", &vectors, &n_clusters, &population, &limit, &f, &mr)) {
+	const char* initialization_name = "uniform";
+	PyObject* warm_start = nullptr;
+	unsigned long long seed = std::mt19937_64::default_seed;
+
+	if (!PyArg_ParseTuple(args, "OKKKdd|sOK", &vectors, &n_clusters, &population, &limit, &f, &mr, &initialization_name, &warm_start, &seed)) {
 		return -1;
 	}
 
@@ -230,7 +1150,7 @@ static int ModBeeColony_init(ModBeeColony* self, PyObject* args) {
 		return -1;
 	}
 
-	self->vectors = new std::vector<std::array<double, VECTOR_DIM>>();
+	self->vectors = new std::vector<Vector>();
 
 	Py_ssize_t n_vectors = PySequence_Size(vectors);
 	self->vectors->resize(n_vectors);
@@ -255,10 +1175,21 @@ static int ModBeeColony_init(ModBeeColony* self, PyObject* args) {
 		}
 	}
 
-	FuzzyClusteringParams<VECTOR_DIM> params;
+	FuzzyClusteringParams<VECTOR_DIM, VECTOR_SCALAR, VECTOR_METRIC> params;
 	params.n_clusters = n_clusters;
 	params.vectors = self->vectors;
-	self->colony_impl = new ModABCFuzzyClustering<VECTOR_DIM>(params, population, limit, DEMixingStrategy<FuzzyClustering<VECTOR_DIM>>(f, mr), RouletteSelectionStrategy(), std::mt19937_64());
+	params.placement = numa_placement;
+	if (!parse_initialization(initialization_name, warm_start, self->vectors->size(), params.initialization)) {
+		return -1;
+	}
+
+	try {
+		self->colony_impl = new ModABCFuzzyClustering<VECTOR_DIM, VECTOR_SCALAR, VECTOR_METRIC>(params, population, limit, DEMixingStrategy<FuzzyClustering<VECTOR_DIM, VECTOR_SCALAR, VECTOR_METRIC>>(f, mr), RouletteSelectionStrategy(), std::mt19937_64(seed));
+	}
+	catch (const std::exception& e) {
+		PyErr_SetString(PyExc_ValueError, e.what());
+		return -1;
+	}
 
 	return 0;
 }
@@ -276,6 +1207,10 @@ static PyObject* ModABC_fit(ModBeeColony* self, PyObject* args) {
 	}
 
 	self->colony_impl->optimize(cycles);
+	//raised by the monitor, see Colony_set_monitor
+	if (PyErr_Occurred()) {
+		return nullptr;
+	}
 
 	Py_RETURN_NONE;
 }
@@ -285,9 +1220,13 @@ static PyObject* ModABC_score(ModBeeColony* self, PyObject* args) {
 }
 
 static PyObject* ModABC_optimize(ModBeeColony* self, PyObject* args) {
-	Py_DECREF(ModABC_fit(self, args));
+	PyObject* fit_result = ModABC_fit(self, args);
+	if (fit_result == nullptr) {
+		return nullptr;
+	}
+	Py_DECREF(fit_result);
 
-	FuzzyClustering<VECTOR_DIM> solution = self->colony_impl->get_champion().get_state();
+	FuzzyClustering<VECTOR_DIM, VECTOR_SCALAR, VECTOR_METRIC> solution = self->colony_impl->get_champion().get_state();
 	PyObject* result = PyList_New(solution.get_n_clusters());
 
 	if (result == nullptr) {
@@ -330,6 +1269,48 @@ static PyMethodDef ModBeeColony_methods[] = {
 	{"score", (PyCFunction)ModABC_score, METH_VARARGS,
 	 "Returns the score of the best solution"
 	},
+	{"stats", (PyCFunction)Colony_stats<ModBeeColony>, METH_NOARGS,
+	 "Returns the performance counters collected so far (empty unless built with ABC_STATS)"
+	},
+	{"reset_stats", (PyCFunction)Colony_reset_stats<ModBeeColony>, METH_NOARGS,
+	 "Resets the performance counters"
+	},
+	{"record_convergence", (PyCFunction)Colony_record_convergence<ModBeeColony>, METH_VARARGS,
+	 "Enables (or with False disables) recording of the convergence trace in subsequent cycles"
+	},
+	{"quality", (PyCFunction)(void(*)(void))Colony_quality<ModBeeColony>, METH_VARARGS | METH_KEYWORDS,
+	 "Returns the validity indices of the best solution and, given the ground truth labels, memberships or centroids (arrays or paths to .pa, .npy or text files), the corresponding external indices"
+	},
+	{"set_monitor", (PyCFunction)Colony_set_monitor<ModBeeColony>, METH_VARARGS,
+	 "Calls the callback with the colony every period cycles; None removes it"
+	},
+	{"set_refinement", (PyCFunction)Colony_set_refinement<ModBeeColony>, METH_VARARGS,
+	 "Every period cycles (0 disables) refines the champion and the given number of fittest bees with fuzzy c-means iterations"
+	},
+	{"convergence", (PyCFunction)Colony_convergence<ModBeeColony>, METH_NOARGS,
+	 "Returns the convergence trace as a list of [champion fitness, mean fitness, evaluations] rows, one per cycle"
+	},
+	{"save_convergence", (PyCFunction)Colony_save_convergence<ModBeeColony>, METH_VARARGS,
+	 "Writes the convergence trace to a .npy file"
+	},
+	{"save", (PyCFunction)Colony_save<ModBeeColony>, METH_VARARGS,
+	 "Writes a binary checkpoint of the colony (without the dataset) to a file"
+	},
+	{"transform", (PyCFunction)Colony_transform<ModBeeColony>, METH_VARARGS,
+	 "Returns the fuzzy memberships of new points with respect to the clusters of the best solution"
+	},
+	{"predict", (PyCFunction)Colony_predict<ModBeeColony>, METH_VARARGS,
+	 "Returns the index of the nearest cluster of the best solution for every new point"
+	},
+	{"append_vectors", (PyCFunction)Colony_append_vectors<ModBeeColony>, METH_VARARGS,
+	 "Appends points to the dataset and extends the population to them, keeping the progress made so far"
+	},
+	{"__getstate__", (PyCFunction)Colony_getstate<ModBeeColony>, METH_NOARGS,
+	 "Returns the dataset, the parameters and a checkpoint of the colony, for pickling"
+	},
+	{"__setstate__", (PyCFunction)Colony_setstate<ModBeeColony>, METH_O,
+	 "Restores the colony from the value returned by __getstate__"
+	},
 	{NULL}
 };
 
@@ -351,7 +1332,11 @@ static int TournamentBeeColony_init(TournamentBeeColony* self, PyObject* args) {
 	size_t n_clusters;
 	PyObject* vectors;
 
-	if (!PyArg_ParseTuple(args, "OKKK", &vectors, &n_clusters, &population, &limit)) {
+	const char* initialization_name = "uniform";
+	PyObject* warm_start = nullptr;
+	unsigned long long seed = std::mt19937_64::default_seed;
+
+	if (!PyArg_ParseTuple(args, "OKKK|sOK", &vectors, &n_clusters, &population, &limit, &initialization_name, &warm_start, &seed)) {
 		return -1;
 	}
 
@@ -359,7 +1344,7 @@ static int TournamentBeeColony_init(TournamentBeeColony* self, PyObject* args) {
 		return -1;
 	}
 
-	self->vectors = new std::vector<std::array<double, VECTOR_DIM>>();
+	self->vectors = new std::vector<Vector>();
 
 	Py_ssize_t n_vectors = PySequence_Size(vectors);
 	self->vectors->resize(n_vectors);
@@ -384,10 +1369,21 @@ static int TournamentBeeColony_init(TournamentBeeColony* self, PyObject* args) {
 		}
 	}
 
-	FuzzyClusteringParams<VECTOR_DIM> params;
+	FuzzyClusteringParams<VECTOR_DIM, VECTOR_SCALAR, VECTOR_METRIC> params;
 	params.n_clusters = n_clusters;
 	params.vectors = self->vectors;
-	self->colony_impl = new TournamentABCFuzzyClustering<VECTOR_DIM>(params, population, limit, ClassicMixingStrategy<FuzzyClustering<VECTOR_DIM>>(), TournamentSelectionStrategy(), std::mt19937_64());
+	params.placement = numa_placement;
+	if (!parse_initialization(initialization_name, warm_start, self->vectors->size(), params.initialization)) {
+		return -1;
+	}
+
+	try {
+		self->colony_impl = new TournamentABCFuzzyClustering<VECTOR_DIM, VECTOR_SCALAR, VECTOR_METRIC>(params, population, limit, ClassicMixingStrategy<FuzzyClustering<VECTOR_DIM, VECTOR_SCALAR, VECTOR_METRIC>>(), TournamentSelectionStrategy(), std::mt19937_64(seed));
+	}
+	catch (const std::exception& e) {
+		PyErr_SetString(PyExc_ValueError, e.what());
+		return -1;
+	}
 
 	return 0;
 }
@@ -405,6 +1401,10 @@ static PyObject* TournamentABC_fit(TournamentBeeColony* self, PyObject* args) {
 	}
 
 	self->colony_impl->optimize(cycles);
+	//raised by the monitor, see Colony_set_monitor
+	if (PyErr_Occurred()) {
+		return nullptr;
+	}
 
 	Py_RETURN_NONE;
 }
@@ -414,9 +1414,13 @@ static PyObject* TournamentABC_score(TournamentBeeColony* self, PyObject* args)
 }
 
 static PyObject* TournamentABC_optimize(TournamentBeeColony* self, PyObject* args) {
-	Py_DECREF(TournamentABC_fit(self, args));
+	PyObject* fit_result = TournamentABC_fit(self, args);
+	if (fit_result == nullptr) {
+		return nullptr;
+	}
+	Py_DECREF(fit_result);
 
-	FuzzyClustering<VECTOR_DIM> solution = self->colony_impl->get_champion().get_state();
+	FuzzyClustering<VECTOR_DIM, VECTOR_SCALAR, VECTOR_METRIC> solution = self->colony_impl->get_champion().get_state();
 	PyObject* result = PyList_New(solution.get_n_clusters());
 
 	if (result == nullptr) {
@@ -459,6 +1463,48 @@ static PyMethodDef TournamentBeeColony_methods[] = {
 	{"score", (PyCFunction)TournamentABC_score, METH_VARARGS,
 	 "Returns the score of the best solution"
 	},
+	{"stats", (PyCFunction)Colony_stats<TournamentBeeColony>, METH_NOARGS,
+	 "Returns the performance counters collected so far (empty unless built with ABC_STATS)"
+	},
+	{"reset_stats", (PyCFunction)Colony_reset_stats<TournamentBeeColony>, METH_NOARGS,
+	 "Resets the performance counters"
+	},
+	{"record_convergence", (PyCFunction)Colony_record_convergence<TournamentBeeColony>, METH_VARARGS,
+	 "Enables (or with False disables) recording of the convergence trace in subsequent cycles"
+	},
+	{"quality", (PyCFunction)(void(*)(void))Colony_quality<TournamentBeeColony>, METH_VARARGS | METH_KEYWORDS,
+	 "Returns the validity indices of the best solution and, given the ground truth labels, memberships or centroids (arrays or paths to .pa, .npy or text files), the corresponding external indices"
+	},
+	{"set_monitor", (PyCFunction)Colony_set_monitor<TournamentBeeColony>, METH_VARARGS,
+	 "Calls the callback with the colony every period cycles; None removes it"
+	},
+	{"set_refinement", (PyCFunction)Colony_set_refinement<TournamentBeeColony>, METH_VARARGS,
+	 "Every period cycles (0 disables) refines the champion and the given number of fittest bees with fuzzy c-means iterations"
+	},
+	{"convergence", (PyCFunction)Colony_convergence<TournamentBeeColony>, METH_NOARGS,
+	 "Returns the convergence trace as a list of [champion fitness, mean fitness, evaluations] rows, one per cycle"
+	},
+	{"save_convergence", (PyCFunction)Colony_save_convergence<TournamentBeeColony>, METH_VARARGS,
+	 "Writes the convergence trace to a .npy file"
+	},
+	{"save", (PyCFunction)Colony_save<TournamentBeeColony>, METH_VARARGS,
+	 "Writes a binary checkpoint of the colony (without the dataset) to a file"
+	},
+	{"transform", (PyCFunction)Colony_transform<TournamentBeeColony>, METH_VARARGS,
+	 "Returns the fuzzy memberships of new points with respect to the clusters of the best solution"
+	},
+	{"predict", (PyCFunction)Colony_predict<TournamentBeeColony>, METH_VARARGS,
+	 "Returns the index of the nearest cluster of the best solution for every new point"
+	},
+	{"append_vectors", (PyCFunction)Colony_append_vectors<TournamentBeeColony>, METH_VARARGS,
+	 "Appends points to the dataset and extends the population to them, keeping the progress made so far"
+	},
+	{"__getstate__", (PyCFunction)Colony_getstate<TournamentBeeColony>, METH_NOARGS,
+	 "Returns the dataset, the parameters and a checkpoint of the colony, for pickling"
+	},
+	{"__setstate__", (PyCFunction)Colony_setstate<TournamentBeeColony>, METH_O,
+	 "Restores the colony from the value returned by __getstate__"
+	},
 	{NULL}
 };
 
@@ -483,7 +1529,11 @@ static int TournamentModBeeColony_init(TournamentModBeeColony* self, PyObject* a
 	size_t n_clusters;
 	PyObject* vectors;
 
-	if (!PyArg_ParseTuple(args, "OKKKdd", &vectors, &n_clusters, &population, &limit, &f, &mr)) {
+	const char* initialization_name = "uniform";
+	PyObject* warm_start = nullptr;
+	unsigned long long seed = std::mt19937_64::default_seed;
+
+	if (!PyArg_ParseTuple(args, "OKKKdd|sOK", &vectors, &n_clusters, &population, &limit, &f, &mr, &initialization_name, &warm_start, &seed)) {
 		return -1;
 	}
 
@@ -491,7 +1541,7 @@ static int TournamentModBeeColony_init(TournamentModBeeColony* self, PyObject* a
 		return -1;
 	}
 
-	self->vectors = new std::vector<std::array<double, VECTOR_DIM>>();
+	self->vectors = new std::vector<Vector>();
 
 	Py_ssize_t n_vectors = PySequence_Size(vectors);
 	self->vectors->resize(n_vectors);
@@ -516,10 +1566,21 @@ static int TournamentModBeeColony_init(TournamentModBeeColony* self, PyObject* a
 		}
 	}
 
-	FuzzyClusteringParams<VECTOR_DIM> params;
+	FuzzyClusteringParams<VECTOR_DIM, VECTOR_SCALAR, VECTOR_METRIC> params;
 	params.n_clusters = n_clusters;
 	params.vectors = self->vectors;
-	self->colony_impl = new TournamentModABCFuzzyClustering<VECTOR_DIM>(params, population, limit, DEMixingStrategy<FuzzyClustering<VECTOR_DIM>>(f, mr), TournamentSelectionStrategy(), std::mt19937_64());
+	params.placement = numa_placement;
+	if (!parse_initialization(initialization_name, warm_start, self->vectors->size(), params.initialization)) {
+		return -1;
+	}
+
+	try {
+		self->colony_impl = new TournamentModABCFuzzyClustering<VECTOR_DIM, VECTOR_SCALAR, VECTOR_METRIC>(params, population, limit, DEMixingStrategy<FuzzyClustering<VECTOR_DIM, VECTOR_SCALAR, VECTOR_METRIC>>(f, mr), TournamentSelectionStrategy(), std::mt19937_64(seed));
+	}
+	catch (const std::exception& e) {
+		PyErr_SetString(PyExc_ValueError, e.what());
+		return -1;
+	}
 
 	return 0;
 }
@@ -537,6 +1598,10 @@ static PyObject* TournamentModABC_fit(TournamentModBeeColony* self, PyObject* ar
 	}
 
 	self->colony_impl->optimize(cycles);
+	//raised by the monitor, see Colony_set_monitor
+	if (PyErr_Occurred()) {
+		return nullptr;
+	}
 
 	Py_RETURN_NONE;
 }
@@ -546,9 +1611,13 @@ static PyObject* TournamentModABC_score(TournamentModBeeColony* self, PyObject*
 }
 
 static PyObject* TournamentModABC_optimize(TournamentModBeeColony* self, PyObject* args) {
-	Py_DECREF(TournamentModABC_fit(self, args));
+	PyObject* fit_result = TournamentModABC_fit(self, args);
+	if (fit_result == nullptr) {
+		return nullptr;
+	}
+	Py_DECREF(fit_result);
 
-	FuzzyClustering<VECTOR_DIM> solution = self->colony_impl->get_champion().get_state();
+	FuzzyClustering<VECTOR_DIM, VECTOR_SCALAR, VECTOR_METRIC> solution = self->colony_impl->get_champion().get_state();
 	PyObject* result = PyList_New(solution.get_n_clusters());
 
 	if (result == nullptr) {
@@ -591,9 +1660,420 @@ static PyMethodDef TournamentModBeeColony_methods[] = {
 	{"score", (PyCFunction)TournamentModABC_score, METH_VARARGS,
 	 "Returns the score of the best solution"
 	},
+	{"stats", (PyCFunction)Colony_stats<TournamentModBeeColony>, METH_NOARGS,
+	 "Returns the performance counters collected so far (empty unless built with ABC_STATS)"
+	},
+	{"reset_stats", (PyCFunction)Colony_reset_stats<TournamentModBeeColony>, METH_NOARGS,
+	 "Resets the performance counters"
+	},
+	{"record_convergence", (PyCFunction)Colony_record_convergence<TournamentModBeeColony>, METH_VARARGS,
+	 "Enables (or with False disables) recording of the convergence trace in subsequent cycles"
+	},
+	{"quality", (PyCFunction)(void(*)(void))Colony_quality<TournamentModBeeColony>, METH_VARARGS | METH_KEYWORDS,
+	 "Returns the validity indices of the best solution and, given the ground truth labels, memberships or centroids (arrays or paths to .pa, .npy or text files), the corresponding external indices"
+	},
+	{"set_monitor", (PyCFunction)Colony_set_monitor<TournamentModBeeColony>, METH_VARARGS,
+	 "Calls the callback with the colony every period cycles; None removes it"
+	},
+	{"set_refinement", (PyCFunction)Colony_set_refinement<TournamentModBeeColony>, METH_VARARGS,
+	 "Every period cycles (0 disables) refines the champion and the given number of fittest bees with fuzzy c-means iterations"
+	},
+	{"convergence", (PyCFunction)Colony_convergence<TournamentModBeeColony>, METH_NOARGS,
+	 "Returns the convergence trace as a list of [champion fitness, mean fitness, evaluations] rows, one per cycle"
+	},
+	{"save_convergence", (PyCFunction)Colony_save_convergence<TournamentModBeeColony>, METH_VARARGS,
+	 "Writes the convergence trace to a .npy file"
+	},
+	{"save", (PyCFunction)Colony_save<TournamentModBeeColony>, METH_VARARGS,
+	 "Writes a binary checkpoint of the colony (without the dataset) to a file"
+	},
+	{"transform", (PyCFunction)Colony_transform<TournamentModBeeColony>, METH_VARARGS,
+	 "Returns the fuzzy memberships of new points with respect to the clusters of the best solution"
+	},
+	{"predict", (PyCFunction)Colony_predict<TournamentModBeeColony>, METH_VARARGS,
+	 "Returns the index of the nearest cluster of the best solution for every new point"
+	},
+	{"append_vectors", (PyCFunction)Colony_append_vectors<TournamentModBeeColony>, METH_VARARGS,
+	 "Appends points to the dataset and extends the population to them, keeping the progress made so far"
+	},
+	{"__getstate__", (PyCFunction)Colony_getstate<TournamentModBeeColony>, METH_NOARGS,
+	 "Returns the dataset, the parameters and a checkpoint of the colony, for pickling"
+	},
+	{"__setstate__", (PyCFunction)Colony_setstate<TournamentModBeeColony>, METH_O,
+	 "Restores the colony from the value returned by __getstate__"
+	},
 	{NULL} 
 };
 
+/*
+sweep_clusters(data, min_clusters, max_clusters, population, limit, cycles, rounds=4) runs an ArtificialBeeColony for every
+number of clusters concurrently (see sweep.h) and returns a list of dictionaries, one per k.
+*/
+static PyObject* sweep_clusters(PyObject* module, PyObject* args) {
+	PyObject* data;
+	unsigned long long min_clusters, max_clusters, population, limit, cycles, rounds = 4;
+
+	if (!PyArg_ParseTuple(args, "OKKKKK|K", &data, &min_clusters, &max_clusters, &population, &limit, &cycles, &rounds)) {
+		return nullptr;
+	}
+
+	std::vector<Vector> vectors;
+	if (!parse_points(data, vectors)) {
+		return nullptr;
+	}
+
+	using Colony = ABCFuzzyClustering<VECTOR_DIM, VECTOR_SCALAR, VECTOR_METRIC>;
+	FuzzyClusteringParams<VECTOR_DIM, VECTOR_SCALAR, VECTOR_METRIC> params;
+	params.n_clusters = min_clusters;
+	params.vectors = &vectors;
+	params.placement = numa_placement;
+
+	std::vector<KSweepResult> results;
+	std::string error;
+	Py_BEGIN_ALLOW_THREADS
+	try {
+		KSweep<Colony> sweep(params, min_clusters, max_clusters, [&](const FuzzyClusteringParams<VECTOR_DIM, VECTOR_SCALAR, VECTOR_METRIC>& colony_params) {
+			return std::make_unique<Colony>(colony_params, population, limit, ClassicMixingStrategy<FuzzyClustering<VECTOR_DIM, VECTOR_SCALAR, VECTOR_METRIC>>(), RouletteSelectionStrategy(), std::mt19937_64(colony_params.n_clusters));
+		});
+		sweep.run(cycles, rounds);
+		results = sweep.results();
+	}
+	catch (const std::exception& e) {
+		error = e.what();
+	}
+	Py_END_ALLOW_THREADS
+
+	if (!error.empty()) {
+		PyErr_SetString(PyExc_ValueError, error.c_str());
+		return nullptr;
+	}
+
+	PyObject* result = PyList_New(results.size());
+	if (result == nullptr) {
+		return nullptr;
+	}
+
+	for (size_t result_idx = 0; result_idx < results.size(); ++result_idx) {
+		const KSweepResult& k_result = results[result_idx];
+		PyObject* centers = values_to_array(k_result.centers, k_result.n_clusters, VECTOR_DIM);
+		if (centers == nullptr) {
+			Py_DECREF(result);
+			return nullptr;
+		}
+
+		PyObject* entry = Py_BuildValue("{s:K,s:d,s:K,s:d,s:d,s:d,s:N}",
+			"n_clusters", (unsigned long long)k_result.n_clusters,
+			"fitness", k_result.fitness,
+			"evaluations", (unsigned long long)k_result.evaluations,
+			"partition_coefficient", k_result.validity.partition_coefficient,
+			"partition_entropy", k_result.validity.partition_entropy,
+			"xie_beni", k_result.validity.xie_beni,
+			"centers", centers);
+		if (entry == nullptr) {
+			Py_DECREF(result);
+			return nullptr;
+		}
+
+		PyList_SetItem(result, result_idx, entry);
+	}
+
+	return result;
+}
+
+/*
+restart_colonies(data, n_clusters, population, limit, cycles, restarts, seed=0, dominance=0.95, check_period=0) runs
+ArtificialBeeColony restarts in parallel (see restarts.h) and returns the colony of the best one, which owns the dataset,
+and a list of dictionaries, one per restart.
+*/
+static PyObject* restart_colonies(PyObject* module, PyObject* args) {
+	PyObject* data;
+	unsigned long long n_clusters, population, limit, cycles, n_restarts, seed = 0, check_period = 0;
+	double dominance = 0.95;
+
+	if (!PyArg_ParseTuple(args, "OKKKKK|KdK", &data, &n_clusters, &population, &limit, &cycles, &n_restarts, &seed, &dominance, &check_period)) {
+		return nullptr;
+	}
+
+	std::unique_ptr<std::vector<Vector>> vectors = std::make_unique<std::vector<Vector>>();
+	if (!parse_points(data, *vectors)) {
+		return nullptr;
+	}
+
+	using Colony = ABCFuzzyClustering<VECTOR_DIM, VECTOR_SCALAR, VECTOR_METRIC>;
+	FuzzyClusteringParams<VECTOR_DIM, VECTOR_SCALAR, VECTOR_METRIC> params;
+	params.n_clusters = n_clusters;
+	params.vectors = vectors.get();
+	params.placement = numa_placement;
+
+	std::unique_ptr<Colony> best;
+	std::vector<RestartResult> results;
+	std::string error;
+	Py_BEGIN_ALLOW_THREADS
+	try {
+		ParallelRestarts<Colony> restarts(params, n_restarts, seed, [&](const FuzzyClusteringParams<VECTOR_DIM, VECTOR_SCALAR, VECTOR_METRIC>& colony_params, uint64_t colony_seed) {
+			return std::make_unique<Colony>(colony_params, population, limit, ClassicMixingStrategy<FuzzyClustering<VECTOR_DIM, VECTOR_SCALAR, VECTOR_METRIC>>(), RouletteSelectionStrategy(), std::mt19937_64(colony_seed));
+		});
+		RestartSchedule schedule;
+		schedule.check_period = check_period;
+		schedule.dominance = dominance;
+		restarts.run(cycles, schedule);
+		results = restarts.results();
+		best = restarts.release_best();
+	}
+	catch (const std::exception& e) {
+		error = e.what();
+	}
+	Py_END_ALLOW_THREADS
+
+	if (!error.empty()) {
+		PyErr_SetString(PyExc_ValueError, error.c_str());
+		return nullptr;
+	}
+
+	PyObject* runs = PyList_New(results.size());
+	if (runs == nullptr) {
+		return nullptr;
+	}
+	for (size_t result_idx = 0; result_idx < results.size(); ++result_idx) {
+		const RestartResult& result = results[result_idx];
+		PyObject* entry = Py_BuildValue("{s:K,s:d,s:K,s:K,s:O}",
+			"seed", (unsigned long long)result.seed,
+			"fitness", result.fitness,
+			"evaluations", (unsigned long long)result.evaluations,
+			"cycles", (unsigned long long)result.cycles,
+			"cancelled", result.cancelled ? Py_True : Py_False);
+		if (entry == nullptr) {
+			Py_DECREF(runs);
+			return nullptr;
+		}
+
+		PyList_SetItem(runs, result_idx, entry);
+	}
+
+	BeeColony* colony = (BeeColony*)BeeColony_new(&BeeColonyType, nullptr, nullptr);
+	if (colony == nullptr) {
+		Py_DECREF(runs);
+		return nullptr;
+	}
+	colony->colony_impl = best.release();
+	colony->vectors = vectors.release();
+
+	return Py_BuildValue("(NN)", (PyObject*)colony, runs);
+}
+
+//reads a sequence of numbers, setting a Python exception on failure
+template <typename T>
+static bool parse_numbers(PyObject* object, const char* name, std::vector<T>& result) {
+	PyObject* sequence = PySequence_Fast(object, name);
+	if (sequence == nullptr) {
+		return false;
+	}
+
+	Py_ssize_t size = PySequence_Fast_GET_SIZE(sequence);
+	for (Py_ssize_t idx = 0; idx < size; ++idx) {
+		PyObject* item = PySequence_Fast_GET_ITEM(sequence, idx);
+		double value = PyFloat_AsDouble(item);
+		if (value == -1.0 && PyErr_Occurred()) {
+			Py_DECREF(sequence);
+			return false;
+		}
+		if (value < 0.0) {
+			Py_DECREF(sequence);
+			PyErr_Format(PyExc_ValueError, "%s must not be negative", name);
+			return false;
+		}
+		result.push_back(static_cast<T>(value));
+	}
+
+	Py_DECREF(sequence);
+	if (result.empty()) {
+		PyErr_Format(PyExc_ValueError, "%s must not be empty", name);
+		return false;
+	}
+	return true;
+}
+
+/*
+tune_colonies(data, n_clusters, min_evaluations, populations, limits, fs, mrs, eta=3, seed=0) tunes a
+ModArtificialBeeColony over the grid of the given values by successive halving (see tuning.h) and returns the colony of
+the winning configuration, which owns the dataset, the configuration as a dictionary and a list of dictionaries, one per
+configuration.
+*/
+static PyObject* tune_colonies(PyObject* module, PyObject* args) {
+	PyObject* data;
+	PyObject* population_values;
+	PyObject* limit_values;
+	PyObject* f_values;
+	PyObject* mr_values;
+	unsigned long long n_clusters, min_evaluations, eta = 3, seed = 0;
+
+	if (!PyArg_ParseTuple(args, "OKKOOOO|KK", &data, &n_clusters, &min_evaluations, &population_values, &limit_values, &f_values, &mr_values, &eta, &seed)) {
+		return nullptr;
+	}
+
+	std::vector<size_t> populations, limits;
+	std::vector<double> fs, mrs;
+	if (!parse_numbers(population_values, "populations", populations) || !parse_numbers(limit_values, "limits", limits) ||
+		!parse_numbers(f_values, "fs", fs) || !parse_numbers(mr_values, "mrs", mrs)) {
+		return nullptr;
+	}
+
+	std::vector<ColonyConfig> configs;
+	for (size_t population : populations) {
+		for (size_t limit : limits) {
+			for (double f : fs) {
+				for (double mr : mrs) {
+					configs.push_back(ColonyConfig{ population, limit, f, mr });
+				}
+			}
+		}
+	}
+
+	std::unique_ptr<std::vector<Vector>> vectors = std::make_unique<std::vector<Vector>>();
+	if (!parse_points(data, *vectors)) {
+		return nullptr;
+	}
+
+	using Colony = ModABCFuzzyClustering<VECTOR_DIM, VECTOR_SCALAR, VECTOR_METRIC>;
+	FuzzyClusteringParams<VECTOR_DIM, VECTOR_SCALAR, VECTOR_METRIC> params;
+	params.n_clusters = n_clusters;
+	params.vectors = vectors.get();
+	params.placement = numa_placement;
+
+	std::unique_ptr<Colony> best;
+	ColonyConfig best_config{};
+	std::vector<TuningResult> results;
+	std::string error;
+	Py_BEGIN_ALLOW_THREADS
+	try {
+		SuccessiveHalving<Colony> tuning(params, configs, seed, [](const FuzzyClusteringParams<VECTOR_DIM, VECTOR_SCALAR, VECTOR_METRIC>& colony_params, const ColonyConfig& config, uint64_t colony_seed) {
+			return std::make_unique<Colony>(colony_params, config.population, config.limit, DEMixingStrategy<FuzzyClustering<VECTOR_DIM, VECTOR_SCALAR, VECTOR_METRIC>>(config.f, config.mr), RouletteSelectionStrategy(), std::mt19937_64(colony_seed));
+		});
+		tuning.run(min_evaluations, eta);
+		results = tuning.results();
+		best_config = tuning.get_best_config();
+		best = tuning.release_best();
+	}
+	catch (const std::exception& e) {
+		error = e.what();
+	}
+	Py_END_ALLOW_THREADS
+
+	if (!error.empty()) {
+		PyErr_SetString(PyExc_ValueError, error.c_str());
+		return nullptr;
+	}
+
+	auto config_to_dict = [](const ColonyConfig& config) {
+		return Py_BuildValue("{s:K,s:K,s:d,s:d}", "population", (unsigned long long)config.population, "limit", (unsigned long long)config.limit, "f", config.f, "mr", config.mr);
+	};
+
+	PyObject* runs = PyList_New(results.size());
+	if (runs == nullptr) {
+		return nullptr;
+	}
+	for (size_t result_idx = 0; result_idx < results.size(); ++result_idx) {
+		const TuningResult& result = results[result_idx];
+		PyObject* entry = Py_BuildValue("{s:N,s:d,s:K,s:K}",
+			"config", config_to_dict(result.config),
+			"fitness", result.fitness,
+			"evaluations", (unsigned long long)result.evaluations,
+			"rounds", (unsigned long long)result.rounds);
+		if (entry == nullptr) {
+			Py_DECREF(runs);
+			return nullptr;
+		}
+
+		PyList_SetItem(runs, result_idx, entry);
+	}
+
+	ModBeeColony* colony = (ModBeeColony*)ModBeeColony_new(&ModBeeColonyType, nullptr, nullptr);
+	if (colony == nullptr) {
+		Py_DECREF(runs);
+		return nullptr;
+	}
+	colony->colony_impl = best.release();
+	colony->vectors = vectors.release();
+
+	return Py_BuildValue("(NNN)", (PyObject*)colony, config_to_dict(best_config), runs);
+}
+
+static PyObject* read_partition_file(PyObject* module, PyObject* args) {
+	const char* path;
+
+	if (!PyArg_ParseTuple(args, "s", &path)) {
+		return nullptr;
+	}
+
+	std::vector<int64_t> labels;
+	try {
+		labels = read_partition(path);
+	}
+	catch (const std::exception& e) {
+		PyErr_SetString(PyExc_OSError, e.what());
+		return nullptr;
+	}
+
+	return values_to_array(labels, labels.size(), 0);
+}
+
+static PyObject* set_numa(PyObject* module, PyObject* args) {
+	const char* placement_name;
+	int pin_threads = 0;
+
+	if (!PyArg_ParseTuple(args, "s|p", &placement_name, &pin_threads)) {
+		return nullptr;
+	}
+
+	try {
+		numa_placement = parse_numa_placement(placement_name);
+	}
+	catch (const std::exception& e) {
+		PyErr_SetString(PyExc_ValueError, e.what());
+		return nullptr;
+	}
+	set_thread_pinning(pin_threads != 0);
+
+	return PyLong_FromSize_t(numa_node_count());
+}
+
+/*
+The pool is shared by every colony and module function of the process, see parallel.h. It may be resized while other
+Python threads run colonies: their loops keep their queued work and continue on the new threads. The GIL is released
+while the workers finish their current tasks.
+*/
+static PyObject* set_num_threads(PyObject* module, PyObject* args) {
+	unsigned long long n_threads;
+
+	if (!PyArg_ParseTuple(args, "K", &n_threads)) {
+		return nullptr;
+	}
+	if (n_threads < 1) {
+		PyErr_SetString(PyExc_ValueError, "at least one thread is needed");
+		return nullptr;
+	}
+
+	std::string error;
+	Py_BEGIN_ALLOW_THREADS
+	try {
+		set_thread_count(n_threads);
+	}
+	catch (const std::exception& e) {
+		error = e.what();
+	}
+	Py_END_ALLOW_THREADS
+
+	if (!error.empty()) {
+		PyErr_SetString(PyExc_RuntimeError, error.c_str());
+		return nullptr;
+	}
+	Py_RETURN_NONE;
+}
+
+static PyObject* get_num_threads(PyObject* module, PyObject*) {
+	return PyLong_FromSize_t(default_thread_count());
+}
+
 PyMODINIT_FUNC PyInit_abc_plusplus(void) {
 	BeeColonyType.tp_name = "abc_plusplus.ArtificialBeeColony";
 	BeeColonyType.tp_doc = "Simple Artificial Bee Colony";
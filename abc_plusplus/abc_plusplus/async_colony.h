@@ -0,0 +1,451 @@
+/*
+Asynchronous steady-state variant of the colony: instead of cycles of employed, onlooker and scout phases separated by
+barriers, every worker thread repeatedly picks a bee, mutates it, evaluates the trial and commits it if it is fitter,
+independently of the other workers. A slow evaluation therefore only delays its own worker.
+
+Every food source is an immutable AsyncBee in a heap-allocated node, and every slot of the population is a
+std::atomic pointer to a node. Workers read the slots with plain atomic loads and commit with a compare-and-swap
+against the node they mutated, so a commit based on a food source that another worker replaced in the meantime is
+discarded (and counted as stale) instead of overwriting the newer one. The champion is published the same way and
+only ever replaced by a fitter food source. The sum of the fitness values (for the selection) and the fitness of the
+champion are kept in atomics updated on commit. No locks are taken on the path of a trial.
+
+Replaced nodes are reclaimed with epoch-based reclamation: a worker announces the global epoch while it runs a trial,
+a node that is no longer referenced by a slot or the champion is retired with the epoch of its removal, and it is
+deleted once the epoch has advanced twice since, which it only does when every worker running a trial has announced
+the current one. A node read during a trial therefore stays valid (and its address is not reused) until the trial is
+over, which also makes the compare-and-swap on the pointers safe from ABA.
+
+The schedule follows the generational colony as closely as it can without barriers: trials alternate between the next
+bee in round-robin order (the employed bees) and a bee chosen by the selection strategy (the onlookers), so a "cycle"
+is 2 * population trials. A bee is abandoned for a random food source when a trial on it fails and it has not
+improved for limit cycles' worth of trials. An adaptive mixing strategy (see is_adaptive_mixing_strategy in colonies.h)
+learns from the trials of its worker, a cycle being population of them.
+*/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include "colonies.h"
+#include "convergence.h"
+#include "parallel.h"
+
+template <typename ProblemType>
+struct AsyncBee {
+	ProblemType problem;
+	typename ProblemType::fitness_type fitness;
+	//the number of evaluations of the colony when the food source was found
+	uint64_t found_at;
+
+	const ProblemType& get_state() const noexcept {
+		return problem;
+	}
+
+	typename ProblemType::fitness_type get_fitness() const noexcept {
+		return fitness;
+	}
+};
+
+//the counters of all workers, summed at the end of every optimize
+struct AsyncColonyStats {
+	uint64_t trials = 0;
+	uint64_t improvements = 0;
+	//improvements discarded because another worker had replaced the food source first
+	uint64_t stale_commits = 0;
+	uint64_t scouts = 0;
+	uint64_t champion_updates = 0;
+};
+
+/*
+	ProblemType, MixingStrategy, SelectionStrategy, RNGType - as for ArtificialBeeColony. Every worker uses its own
+	copies of the strategies and its own RNG, seeded from the RNG passed to the constructor, so a run is reproducible
+	only with a single thread.
+*/
+template <typename ProblemType, typename MixingStrategy, typename SelectionStrategy, typename RNGType>
+class AsyncArtificialBeeColony {
+public:
+	using problem_type = ProblemType;
+	using mixing_strategy_type = MixingStrategy;
+	using selection_strategy_type = SelectionStrategy;
+	using bee_type = AsyncBee<ProblemType>;
+	using fitness_type = typename ProblemType::fitness_type;
+
+	AsyncArtificialBeeColony(typename ProblemType::params_type problem_params, size_t population, size_t limit, MixingStrategy mixing_strategy, SelectionStrategy selection_strategy, RNGType&& rng, size_t n_threads = default_thread_count()):
+		problem_params(ProblemType::prepare_params(problem_params)),
+		limit(limit),
+		slots(population),
+		evaluations(population * initialization_evaluations(this->problem_params.initialization.get())),
+		next_trial(0),
+		epoch(0),
+		convergence_enabled(false) {
+
+		check_population(population);
+
+		n_threads = std::max<size_t>(n_threads, 1);
+		for (size_t worker_idx = 0; worker_idx < n_threads; ++worker_idx) {
+			workers.push_back(Worker{ mixing_strategy, selection_strategy, RNGType(rng()), {} });
+		}
+		//one per worker and the last one for the readers outside optimize
+		pinned_epochs = std::make_unique<std::atomic<uint64_t>[]>(n_threads + 1);
+		for (size_t pin_idx = 0; pin_idx <= n_threads; ++pin_idx) {
+			pinned_epochs[pin_idx] = quiescent;
+		}
+
+		//the seeds are drawn up front so that the population does not depend on the order of the threads
+		std::vector<typename RNGType::result_type> seeds(population);
+		for (auto& seed : seeds) {
+			seed = rng();
+		}
+		parallel_for(population, 1, [&](size_t begin, size_t end) {
+			for (size_t bee_idx = begin; bee_idx < end; ++bee_idx) {
+				RNGType bee_rng(seeds[bee_idx]);
+				std::pair<ProblemType, fitness_type> solution = random_solution<ProblemType>(this->problem_params, bee_rng);
+				slots[bee_idx] = new Node{ bee_type{ std::move(solution.first), solution.second, 0 }, 1 };
+			}
+		}, n_threads);
+
+		Node* best = slots.front();
+		fitness_type total = 0;
+		for (const std::atomic<Node*>& slot : slots) {
+			Node* node = slot.load();
+			total += node->bee.fitness;
+			if (node->bee.fitness > best->bee.fitness) {
+				best = node;
+			}
+		}
+		++best->owners;
+		champion = best;
+		champion_fitness = best->bee.fitness;
+		all_nectar = total;
+	}
+
+	AsyncArtificialBeeColony(const AsyncArtificialBeeColony&) = delete;
+	AsyncArtificialBeeColony& operator=(const AsyncArtificialBeeColony&) = delete;
+
+	~AsyncArtificialBeeColony() {
+		std::vector<Node*> nodes;
+		for (const std::atomic<Node*>& slot : slots) {
+			nodes.push_back(slot.load());
+		}
+		nodes.push_back(champion.load());
+		for (const Worker& worker : workers) {
+			for (const Retired& retired : worker.limbo) {
+				nodes.push_back(retired.node);
+			}
+		}
+		std::sort(nodes.begin(), nodes.end());
+		for (auto node = nodes.cbegin(); node != nodes.cend(); node = std::upper_bound(node, nodes.cend(), *node)) {
+			delete *node;
+		}
+	}
+
+	//runs max_iterations * 2 * population trials spread over the workers
+	void optimize(size_t max_iterations) {
+		const uint64_t first_trial = next_trial.load();
+		const uint64_t end_trial = first_trial + max_iterations * cycle_trials();
+		if (convergence_enabled) {
+			convergence.reserve(convergence.get_records().size() + max_iterations);
+		}
+
+		parallel_for(workers.size(), 1, [&](size_t begin, size_t end) {
+			for (size_t worker_idx = begin; worker_idx < end; ++worker_idx) {
+				work(worker_idx, first_trial, end_trial, max_iterations);
+			}
+		}, workers.size());
+
+		//a worker may have claimed trials past the end before noticing it
+		next_trial = end_trial;
+
+		//no trial runs any more, so everything retired can go unless a reader outside optimize holds it
+		try_advance();
+		try_advance();
+		for (Worker& worker : workers) {
+			reclaim(worker.limbo);
+		}
+	}
+
+	//a copy of the champion; safe to call while optimize runs in another thread
+	std::shared_ptr<const bee_type> get_champion() const {
+		ReaderPin pin(*this);
+		return std::make_shared<const bee_type>(champion.load()->bee);
+	}
+
+	//a copy of the population; safe to call while optimize runs in another thread
+	std::vector<std::shared_ptr<const bee_type>> get_population() const {
+		ReaderPin pin(*this);
+		std::vector<std::shared_ptr<const bee_type>> result;
+		result.reserve(slots.size());
+		for (const std::atomic<Node*>& slot : slots) {
+			result.push_back(std::make_shared<const bee_type>(slot.load()->bee));
+		}
+		return result;
+	}
+
+	const typename ProblemType::params_type& get_problem_params() const noexcept {
+		return problem_params;
+	}
+
+	size_t get_thread_count() const noexcept {
+		return workers.size();
+	}
+
+	//the total number of fitness evaluations, including those of the initial population
+	uint64_t get_evaluations() const noexcept {
+		return evaluations.load();
+	}
+
+	const AsyncColonyStats& get_stats() const noexcept {
+		return stats;
+	}
+
+	//when enabled, a record is appended every 2 * population trials
+	void record_convergence(bool enabled) noexcept {
+		convergence_enabled = enabled;
+	}
+
+	const ConvergenceTrace& get_convergence() const noexcept {
+		return convergence;
+	}
+
+	void clear_convergence() {
+		convergence.clear();
+	}
+
+private:
+	static constexpr uint64_t quiescent = std::numeric_limits<uint64_t>::max();
+	//the number of retired nodes a worker collects before it tries to reclaim them
+	static constexpr size_t reclaim_batch = 16;
+
+	//a food source as published; owners counts the slots and the champion referring to it (and a pending claim on the champion)
+	struct Node {
+		bee_type bee;
+		std::atomic<uint32_t> owners;
+	};
+
+	struct Retired {
+		Node* node;
+		uint64_t epoch;
+	};
+
+	/*
+	What the mixing and selection strategies see of a bee: the food source currently in the slot, except for the bee
+	being mutated, which is pinned to the node the worker read so that the trial and the commit refer to the same one.
+	*/
+	struct BeeView {
+		const std::atomic<Node*>* slot;
+		const bee_type* pinned;
+
+		const bee_type& get_bee() const noexcept {
+			return pinned ? *pinned : slot->load(std::memory_order_acquire)->bee;
+		}
+
+		const ProblemType& get_state() const noexcept {
+			return get_bee().problem;
+		}
+
+		fitness_type get_fitness() const noexcept {
+			return get_bee().fitness;
+		}
+	};
+
+	struct Worker {
+		MixingStrategy mixing_strategy;
+		SelectionStrategy selection_strategy;
+		RNGType rng;
+		std::vector<Retired> limbo;
+	};
+
+	//announces the epoch for a reader outside optimize; such readers take turns, the workers never wait for them
+	class ReaderPin {
+	public:
+		explicit ReaderPin(const AsyncArtificialBeeColony& colony):
+			colony(colony),
+			lock(colony.reader_mutex) {
+			colony.pin(colony.workers.size());
+		}
+
+		~ReaderPin() {
+			colony.unpin(colony.workers.size());
+		}
+
+	private:
+		const AsyncArtificialBeeColony& colony;
+		std::lock_guard<std::mutex> lock;
+	};
+
+	uint64_t cycle_trials() const noexcept {
+		return 2 * slots.size();
+	}
+
+	void pin(size_t pin_idx) const noexcept {
+		pinned_epochs[pin_idx].store(epoch.load());
+	}
+
+	void unpin(size_t pin_idx) const noexcept {
+		pinned_epochs[pin_idx].store(quiescent, std::memory_order_release);
+	}
+
+	//moves to the next epoch if everybody in a trial (or reading) has announced the current one
+	void try_advance() noexcept {
+		uint64_t current = epoch.load();
+		for (size_t pin_idx = 0; pin_idx <= workers.size(); ++pin_idx) {
+			const uint64_t pinned = pinned_epochs[pin_idx].load();
+			if (pinned != quiescent && pinned != current) {
+				return;
+			}
+		}
+		epoch.compare_exchange_strong(current, current + 1);
+	}
+
+	//deletes the nodes nobody can still be reading: those retired at least two epochs ago
+	void reclaim(std::vector<Retired>& limbo) noexcept {
+		const uint64_t current = epoch.load();
+		auto kept = std::partition(limbo.begin(), limbo.end(), [current](const Retired& retired) { return retired.epoch + 2 > current; });
+		for (auto retired = kept; retired != limbo.end(); ++retired) {
+			delete retired->node;
+		}
+		limbo.erase(kept, limbo.end());
+	}
+
+	//drops a reference to the node, retiring it with the last one
+	void release(Node* node, Worker& worker) {
+		if (node->owners.fetch_sub(1) == 1) {
+			worker.limbo.push_back(Retired{ node, epoch.load() });
+		}
+	}
+
+	static void add_to(std::atomic<fitness_type>& sum, fitness_type delta) noexcept {
+		fitness_type current = sum.load(std::memory_order_relaxed);
+		while (!sum.compare_exchange_weak(current, current + delta, std::memory_order_relaxed)) {
+		}
+	}
+
+	void work(size_t worker_idx, uint64_t first_trial, uint64_t end_trial, size_t max_iterations) {
+		Worker& worker = workers[worker_idx];
+		const size_t population = slots.size();
+		const uint64_t abandon_after = limit * cycle_trials();
+		worker.selection_strategy.set_size(population, max_iterations);
+
+		AsyncColonyStats local;
+		std::vector<BeeView> swarm;
+		swarm.reserve(population);
+		for (const std::atomic<Node*>& slot : slots) {
+			swarm.push_back(BeeView{ &slot, nullptr });
+		}
+		const BeeView champion_view{ &champion, nullptr };
+
+		for (uint64_t trial = next_trial++; trial < end_trial; trial = next_trial++) {
+			pin(worker_idx);
+			const fitness_type nectar = all_nectar.load(std::memory_order_relaxed);
+
+			const size_t iteration = static_cast<size_t>((trial - first_trial) / cycle_trials());
+			size_t bee_idx;
+			if (trial % 2 == 0) {
+				bee_idx = static_cast<size_t>(trial / 2 % population);
+			}
+			else {
+				bee_idx = worker.selection_strategy.select(nectar, swarm, iteration, worker.rng);
+			}
+
+			Node* current = slots[bee_idx].load(std::memory_order_acquire);
+			swarm[bee_idx].pinned = &current->bee;
+			ProblemType hybrid = worker.mixing_strategy.mutate(bee_idx, swarm, champion_view, worker.rng);
+			swarm[bee_idx].pinned = nullptr;
+			fitness_type fitness = hybrid.compute_fitness();
+			const uint64_t evaluated = ++evaluations;
+			++local.trials;
+			if constexpr (is_adaptive_mixing_strategy<MixingStrategy>::value) {
+				worker.mixing_strategy.record_trial(fitness > current->bee.fitness, fitness > current->bee.fitness ? static_cast<double>(fitness - current->bee.fitness) : 0.0);
+				if (local.trials % population == 0) {
+					worker.mixing_strategy.end_cycle();
+				}
+			}
+
+			if (fitness > current->bee.fitness) {
+				if (commit(bee_idx, current, new Node{ bee_type{ std::move(hybrid), fitness, evaluated }, 2 }, worker, local)) {
+					++local.improvements;
+				}
+			}
+			else if (evaluated - current->bee.found_at > abandon_after) {
+				std::pair<ProblemType, fitness_type> scout = random_solution<ProblemType>(problem_params, worker.rng);
+				const uint64_t scouted = evaluations += initialization_evaluations(problem_params.initialization.get());
+				if (commit(bee_idx, current, new Node{ bee_type{ std::move(scout.first), scout.second, scouted }, 2 }, worker, local)) {
+					++local.scouts;
+				}
+			}
+			unpin(worker_idx);
+
+			if (convergence_enabled && (trial - first_trial + 1) % cycle_trials() == 0) {
+				std::lock_guard<std::mutex> lock(mutex);
+				convergence.record(champion_fitness.load(), all_nectar.load() / population, evaluations.load());
+			}
+
+			if (worker.limbo.size() >= reclaim_batch) {
+				try_advance();
+				reclaim(worker.limbo);
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(mutex);
+		stats.trials += local.trials;
+		stats.improvements += local.improvements;
+		stats.stale_commits += local.stale_commits;
+		stats.scouts += local.scouts;
+		stats.champion_updates += local.champion_updates;
+	}
+
+	/*
+	Replaces the food source of the slot unless another worker has replaced it since it was read as expected. The new
+	node comes with two references: the slot and the claim on the champion, which is dropped unless it wins.
+	*/
+	bool commit(size_t bee_idx, Node* expected, Node* node, Worker& worker, AsyncColonyStats& local) {
+		if (!slots[bee_idx].compare_exchange_strong(expected, node, std::memory_order_acq_rel)) {
+			delete node;
+			++local.stale_commits;
+			return false;
+		}
+		add_to(all_nectar, node->bee.fitness - expected->bee.fitness);
+		release(expected, worker);
+
+		Node* current_champion = champion.load(std::memory_order_acquire);
+		while (node->bee.fitness > current_champion->bee.fitness) {
+			if (champion.compare_exchange_weak(current_champion, node, std::memory_order_acq_rel)) {
+				fitness_type best = champion_fitness.load();
+				while (node->bee.fitness > best && !champion_fitness.compare_exchange_weak(best, node->bee.fitness)) {
+				}
+				++local.champion_updates;
+				release(current_champion, worker);
+				return true;
+			}
+		}
+		release(node, worker);
+		return true;
+	}
+
+	typename ProblemType::params_type problem_params;
+	size_t limit;
+	std::vector<std::atomic<Node*>> slots;
+	std::atomic<Node*> champion;
+	std::atomic<fitness_type> champion_fitness;
+	std::atomic<fitness_type> all_nectar;
+	std::vector<Worker> workers;
+
+	std::atomic<uint64_t> evaluations;
+	std::atomic<uint64_t> next_trial;
+
+	std::atomic<uint64_t> epoch;
+	std::unique_ptr<std::atomic<uint64_t>[]> pinned_epochs;
+	mutable std::mutex reader_mutex;
+
+	std::mutex mutex;
+	AsyncColonyStats stats;
+	bool convergence_enabled;
+	ConvergenceTrace convergence;
+};
@@ -0,0 +1,177 @@
+/*
+Binary checkpoint format of ArtificialBeeColony (see ArtificialBeeColony::save and ArtificialBeeColony::load).
+
+All values are stored in native byte order:
+	header       - magic "ABCCKPT\0", uint32 format version, uint32 size of a solution value in bytes,
+	               uint64 population, uint64 values per solution, uint64 evaluation count, double all_nectar,
+	               uint64 length of the RNG state followed by the RNG state in its textual form,
+	               the AdaptiveLimit (uint64 enabled, double patience, double decay, uint64 min_limit, uint64 max_limit),
+	               uint64 1 when mixing states follow the bee table, 0 otherwise
+	bee table    - population + 1 entries (the champion last) of uint64 limit, uint64 remaining cycles, double fitness,
+	               uint64 cycles since the last improvement, double mean interval between improvements, uint64 1 when
+	               the bee improved in the current cycle
+	mixing state - for adaptive mixing strategies only, population + 1 states in the same order, as written by
+	               AdaptiveDEMixingStrategy::save
+	weight slabs - starting at the next multiple of checkpoint_alignment; population + 1 consecutive arrays of
+	               solution values in the same order as the bee table
+
+Because the weight slabs start at a page boundary, they can be memory-mapped directly.
+*/
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+constexpr char checkpoint_magic[8] = { 'A', 'B', 'C', 'C', 'K', 'P', 'T', '\0' };
+constexpr uint32_t checkpoint_version = 2;
+constexpr uint64_t checkpoint_alignment = 4096;
+
+struct CheckpointBeeEntry {
+	uint64_t limit;
+	uint64_t remaining_cycles;
+	double fitness;
+	uint64_t cycles_since_improvement;
+	double mean_interval;
+	uint64_t improved_this_cycle;
+};
+
+class CheckpointWriter {
+public:
+	explicit CheckpointWriter(std::ostream& out) :
+		out(out),
+		position(0) {
+	}
+
+	template <typename ValueType>
+	void write(const ValueType& value) {
+		write_bytes(&value, sizeof(ValueType));
+	}
+
+	template <typename ValueType>
+	void write_values(const std::vector<ValueType>& values) {
+		write_bytes(values.data(), values.size() * sizeof(ValueType));
+	}
+
+	void write_string(const std::string& value) {
+		write<uint64_t>(value.size());
+		write_bytes(value.data(), value.size());
+	}
+
+	void align(uint64_t alignment) {
+		static const char zeros[64] = {};
+		while (position % alignment != 0) {
+			write_bytes(zeros, std::min<uint64_t>(sizeof(zeros), alignment - position % alignment));
+		}
+	}
+
+private:
+	std::ostream& out;
+	uint64_t position;
+
+	void write_bytes(const void* data, size_t size) {
+		out.write(static_cast<const char*>(data), size);
+		if (!out) {
+			throw std::runtime_error("failed to write the checkpoint");
+		}
+		position += size;
+	}
+};
+
+class CheckpointReader {
+public:
+	explicit CheckpointReader(std::istream& in) :
+		in(in),
+		position(0) {
+	}
+
+	template <typename ValueType>
+	ValueType read() {
+		ValueType value;
+		read_bytes(&value, sizeof(ValueType));
+		return value;
+	}
+
+	template <typename ValueType>
+	std::vector<ValueType> read_values(size_t count) {
+		expect(count, sizeof(ValueType));
+		std::vector<ValueType> values(count);
+		read_bytes(values.data(), count * sizeof(ValueType));
+		return values;
+	}
+
+	std::string read_string() {
+		uint64_t size = read<uint64_t>();
+		expect(size, 1);
+		std::string value(size, '\0');
+		read_bytes(&value[0], value.size());
+		return value;
+	}
+
+	void align(uint64_t alignment) {
+		char padding[64];
+		while (position % alignment != 0) {
+			read_bytes(padding, std::min<uint64_t>(sizeof(padding), alignment - position % alignment));
+		}
+	}
+
+	//throws unless count items of item_size bytes are left, so that a corrupt length does not allocate them up front
+	void expect(uint64_t count, uint64_t item_size) {
+		if (count > remaining() / item_size) {
+			throw std::runtime_error("truncated or corrupt checkpoint");
+		}
+	}
+
+private:
+	std::istream& in;
+	uint64_t position;
+
+	//the bytes left in the stream, or UINT64_MAX when it cannot seek
+	uint64_t remaining() {
+		std::streampos here = in.tellg();
+		if (here < 0 || !in.seekg(0, std::ios::end)) {
+			in.clear();
+			return UINT64_MAX;
+		}
+		std::streampos end = in.tellg();
+		in.seekg(here);
+		return static_cast<uint64_t>(end - here);
+	}
+
+	void read_bytes(void* data, size_t size) {
+		in.read(static_cast<char*>(data), size);
+		if (!in) {
+			throw std::runtime_error("truncated or unreadable checkpoint");
+		}
+		position += size;
+	}
+};
+
+inline void write_checkpoint_header(CheckpointWriter& writer, uint32_t value_size) {
+	writer.write(checkpoint_magic);
+	writer.write(checkpoint_version);
+	writer.write(value_size);
+}
+
+inline void read_checkpoint_header(CheckpointReader& reader, uint32_t value_size) {
+	char magic[sizeof(checkpoint_magic)];
+	for (char& c : magic) {
+		c = reader.read<char>();
+	}
+	if (std::memcmp(magic, checkpoint_magic, sizeof(magic)) != 0) {
+		throw std::runtime_error("not a colony checkpoint");
+	}
+
+	if (reader.read<uint32_t>() != checkpoint_version) {
+		throw std::runtime_error("unsupported checkpoint version");
+	}
+
+	if (reader.read<uint32_t>() != value_size) {
+		throw std::runtime_error("checkpoint was written for a different solution value type");
+	}
+}
@@ -1,14 +1,51 @@
 /*
 Core algorithm logic.
 */
+#pragma once
 
 #include <vector>
 #include <tuple>
 #include <numeric>
 #include <algorithm>
 #include <random>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <functional>
+#include <utility>
+#include <optional>
+#include <stdexcept>
 
 #include "util.h"
+#include "stats.h"
+#include "tracing.h"
+#include "convergence.h"
+#include "checkpoint.h"
+#include "predict.h"
+
+//problems with get_genes(indices) fetch several genes at once, which is cheaper when they are held elsewhere (FuzzyClustering with shards)
+template <typename ProblemType, typename = void>
+struct has_gene_batches : std::false_type {};
+
+template <typename ProblemType>
+struct has_gene_batches<ProblemType, std::void_t<decltype(std::declval<const ProblemType&>().get_genes(std::declval<const std::vector<size_t>&>()))>> : std::true_type {};
+
+template <typename ProblemType>
+std::vector<typename ProblemType::gene_type> get_genes(const ProblemType& problem, const std::vector<size_t>& indices) {
+	if constexpr (has_gene_batches<ProblemType>::value) {
+		return problem.get_genes(indices);
+	}
+	else {
+		std::vector<typename ProblemType::gene_type> result;
+		result.reserve(indices.size());
+		for (size_t index : indices) {
+			result.push_back(problem.get_gene(index));
+		}
+		return result;
+	}
+}
 
 template <typename ProblemType>
 class ClassicMixingStrategy {
@@ -45,6 +82,14 @@ public:
 
 	}
 
+	double get_f() const noexcept {
+		return f;
+	}
+
+	double get_mr() const noexcept {
+		return mr;
+	}
+
 	template <typename BeeType, typename RNGType>
 	ProblemType mutate(size_t bee_idx, const std::vector<BeeType>& swarm, const BeeType& champion, RNGType& rng) {
 		std::array<size_t, 3> buddies = uniform_ints_except<3, RNGType>(0, swarm.size() - 1, bee_idx, rng);
@@ -68,12 +113,27 @@ public:
 			gene_selections[emergency_gene_select_dist(rng)] = 0.0;
 		}
 
+		std::vector<size_t> mutated;
 		for (size_t gene_idx = 0; gene_idx < gene_selections.size(); ++gene_idx) {
 			if (gene_selections[gene_idx] <= mr) {
-				typename ProblemType::gene_type new_gene = champion.get_gene(gene_idx);
-				new_gene += f * (problem.get_gene(gene_idx) - buddy1.get_gene(gene_idx) + buddy2.get_gene(gene_idx) - buddy3.get_gene(gene_idx));
+				mutated.push_back(gene_idx);
+			}
+		}
+
+		//the genes are read in batches, see get_genes
+		for (size_t batch_begin = 0; batch_begin < mutated.size(); batch_begin += mix_batch_size) {
+			const std::vector<size_t> batch(mutated.cbegin() + batch_begin, mutated.cbegin() + std::min(batch_begin + mix_batch_size, mutated.size()));
+			std::vector<typename ProblemType::gene_type> champion_genes = get_genes(champion, batch);
+			const std::vector<typename ProblemType::gene_type> problem_genes = get_genes(problem, batch);
+			const std::vector<typename ProblemType::gene_type> buddy1_genes = get_genes(buddy1, batch);
+			const std::vector<typename ProblemType::gene_type> buddy2_genes = get_genes(buddy2, batch);
+			const std::vector<typename ProblemType::gene_type> buddy3_genes = get_genes(buddy3, batch);
+
+			for (size_t idx = 0; idx < batch.size(); ++idx) {
+				typename ProblemType::gene_type& new_gene = champion_genes[idx];
+				new_gene += f * (problem_genes[idx] - buddy1_genes[idx] + buddy2_genes[idx] - buddy3_genes[idx]);
 				new_gene.repair();
-				problem.set_gene(gene_idx, new_gene);
+				problem.set_gene(batch[idx], new_gene);
 			}
 		}
 
@@ -81,10 +141,149 @@ public:
 	}
 
 private:
+	static constexpr size_t mix_batch_size = 1024;
+
+	double f;
+	double mr;
+};
+
+/*
+Success-history parameter adaptation for DEMixingStrategy, after SHADE (Tanabe & Fukunaga, 2013). Every trial draws
+f from a Cauchy distribution and mr from a normal distribution (both with scale 0.1) around a randomly chosen entry of
+a small history, starting at the f and mr given to the constructor. The parameters of the trials that improved the
+food source are remembered, and at the end of every cycle their means, weighted by the improvement, replace the next
+entry of the history (a Lehmer mean for f, which favours the larger steps, as in SHADE). Every bee holds its own copy
+of the strategy, so the parameters adapt to the bee.
+
+Bee calls record_trial after every trial and end_cycle once per cycle, see is_adaptive_mixing_strategy.
+*/
+template <typename ProblemType>
+class AdaptiveDEMixingStrategy {
+public:
+	AdaptiveDEMixingStrategy(double f, double mr, size_t history_size = 5) :
+		f_history(std::max<size_t>(history_size, 1), f),
+		mr_history(std::max<size_t>(history_size, 1), mr),
+		next_entry(0),
+		f(f),
+		mr(mr) {
+
+	}
+
+	//the means of the history
+	double get_f() const noexcept {
+		return std::accumulate(f_history.cbegin(), f_history.cend(), 0.0) / f_history.size();
+	}
+
+	double get_mr() const noexcept {
+		return std::accumulate(mr_history.cbegin(), mr_history.cend(), 0.0) / mr_history.size();
+	}
+
+	template <typename BeeType, typename RNGType>
+	ProblemType mutate(size_t bee_idx, const std::vector<BeeType>& swarm, const BeeType& champion, RNGType& rng) {
+		size_t entry = std::uniform_int_distribution<size_t>(0, f_history.size() - 1)(rng);
+		mr = std::clamp(std::normal_distribution<double>(mr_history[entry], 0.1)(rng), 0.0, 1.0);
+		std::cauchy_distribution<double> f_dist(f_history[entry], 0.1);
+		do {
+			f = f_dist(rng);
+		} while (f <= 0);
+		f = std::min(f, 1.0);
+
+		return DEMixingStrategy<ProblemType>(f, mr).mutate(bee_idx, swarm, champion, rng);
+	}
+
+	//remembers the parameters of the last mutation if it improved the fitness by improvement
+	void record_trial(bool improved, double improvement) {
+		if (improved) {
+			successes.push_back({ f, mr, improvement });
+		}
+	}
+
+	void end_cycle() {
+		double weight_sum = 0;
+		double f_sum = 0;
+		double f_square_sum = 0;
+		double mr_sum = 0;
+		for (const Success& success : successes) {
+			weight_sum += success.improvement;
+			f_sum += success.improvement * success.f;
+			f_square_sum += success.improvement * success.f * success.f;
+			mr_sum += success.improvement * success.mr;
+		}
+		successes.clear();
+
+		if (weight_sum > 0) {
+			f_history[next_entry] = f_square_sum / f_sum;
+			mr_history[next_entry] = mr_sum / weight_sum;
+			next_entry = (next_entry + 1) % f_history.size();
+		}
+	}
+
+	//uint64 history size, the f and mr histories, uint64 next entry, double f, double mr, uint64 number of successes of the current cycle followed by their f, mr and improvement
+	void save(CheckpointWriter& writer) const {
+		writer.write<uint64_t>(f_history.size());
+		writer.write_values(f_history);
+		writer.write_values(mr_history);
+		writer.write<uint64_t>(next_entry);
+		writer.write(f);
+		writer.write(mr);
+		writer.write<uint64_t>(successes.size());
+		writer.write_values(successes);
+	}
+
+	void load(CheckpointReader& reader) {
+		uint64_t history_size = reader.read<uint64_t>();
+		if (history_size == 0) {
+			throw std::runtime_error("corrupt mixing state in the checkpoint");
+		}
+		f_history = reader.read_values<double>(history_size);
+		mr_history = reader.read_values<double>(history_size);
+		next_entry = reader.read<uint64_t>();
+		if (next_entry >= history_size) {
+			throw std::runtime_error("corrupt mixing state in the checkpoint");
+		}
+		f = reader.read<double>();
+		mr = reader.read<double>();
+		successes = reader.read_values<Success>(reader.read<uint64_t>());
+	}
+
+private:
+	struct Success {
+		double f;
+		double mr;
+		double improvement;
+	};
+
+	std::vector<double> f_history;
+	std::vector<double> mr_history;
+	size_t next_entry;
+	std::vector<Success> successes;
+	//the parameters of the last mutation
 	double f;
 	double mr;
 };
 
+//mixing strategies with record_trial(improved, improvement) and end_cycle() learn from the trials of their bee
+template <typename MixingStrategy, typename = void>
+struct is_adaptive_mixing_strategy : std::false_type {};
+
+template <typename MixingStrategy>
+struct is_adaptive_mixing_strategy<MixingStrategy, std::void_t<decltype(std::declval<MixingStrategy&>().record_trial(true, 0.0)), decltype(std::declval<MixingStrategy&>().end_cycle())>> : std::true_type {};
+
+/*
+Self-adaptive abandonment (see ArtificialBeeColony::set_adaptive_limit): the limit of a bee is patience times the
+number of cycles it has needed to improve, an exponential moving average (with the given decay) of the intervals
+between its improvements, within [min_limit, max_limit]. A bee that improves every few cycles is abandoned soon after
+it stops, while one that improves rarely is given proportionally longer. Only completed intervals count, so a bee
+that is stuck does not extend its own limit. A fresh food source starts with an interval of 1 cycle.
+*/
+struct AdaptiveLimit {
+	bool enabled = false;
+	double patience = 4;
+	double decay = 0.2;
+	size_t min_limit = 10;
+	size_t max_limit = 1000;
+};
+
 template <typename ProblemType, typename MixingStrategy>
 class Bee {
 public:
@@ -93,17 +292,55 @@ public:
 		limit(limit),
 		remaining_cycles(limit),
 		fitness(problem.compute_fitness()),
-		mixing_strategy(mixing_strategy) {
+		mixing_strategy(mixing_strategy),
+		improved_this_cycle(false),
+		cycles_since_improvement(0),
+		mean_interval(1) {
+	}
+
+	//a bee with a fitness computed before, see random_solution
+	Bee(size_t limit, ProblemType problem, typename ProblemType::fitness_type fitness, MixingStrategy mixing_strategy):
+		problem(std::move(problem)),
+		limit(limit),
+		remaining_cycles(limit),
+		fitness(fitness),
+		mixing_strategy(mixing_strategy),
+		improved_this_cycle(false),
+		cycles_since_improvement(0),
+		mean_interval(1) {
+	}
+
+	//restores a bee from a checkpoint without recomputing its fitness
+	Bee(const CheckpointBeeEntry& entry, ProblemType problem, MixingStrategy mixing_strategy):
+		problem(std::move(problem)),
+		limit(entry.limit),
+		remaining_cycles(entry.remaining_cycles),
+		fitness(entry.fitness),
+		mixing_strategy(mixing_strategy),
+		improved_this_cycle(entry.improved_this_cycle != 0),
+		cycles_since_improvement(entry.cycles_since_improvement),
+		mean_interval(entry.mean_interval) {
 	}
 	
-	template <typename RNGType>
-	typename ProblemType::fitness_type explore(size_t my_idx, const std::vector<Bee<ProblemType, MixingStrategy>>& swarm, const Bee<ProblemType, MixingStrategy>& champion, RNGType& rng) {
+	template <typename RNGType, typename TracingPolicy>
+	typename ProblemType::fitness_type explore(size_t my_idx, const std::vector<Bee<ProblemType, MixingStrategy>>& swarm, const Bee<ProblemType, MixingStrategy>& champion, RNGType& rng, PhaseStats& stats, TracingPolicy& tracing) {
+		Stopwatch stopwatch;
 		ProblemType hybrid = mixing_strategy.mutate(my_idx, swarm, champion, rng);
+		stopwatch.lap(stats.mixing_ns);
 
+		tracing.begin("evaluate");
 		typename ProblemType::fitness_type new_fitness = hybrid.compute_fitness();
+		tracing.end("evaluate");
+		stopwatch.lap(stats.evaluation_ns);
+
+		stats.record_trial(new_fitness > fitness);
+		if constexpr (is_adaptive_mixing_strategy<MixingStrategy>::value) {
+			mixing_strategy.record_trial(new_fitness > fitness, new_fitness > fitness ? static_cast<double>(new_fitness - fitness) : 0.0);
+		}
 		if (new_fitness > fitness) {
 			problem = std::move(hybrid);
 			remaining_cycles = limit;
+			improved_this_cycle = true;
 
 			typename ProblemType::fitness_type delta = new_fitness - fitness;
 			fitness = new_fitness;
@@ -118,13 +355,29 @@ public:
 		return fitness;
 	}
 
-	template <typename RNGType>
-	typename ProblemType::fitness_type tire(RNGType& rng) {
+	template <typename RNGType, typename TracingPolicy>
+	//scout_evaluations - the evaluations a new solution takes (initialization_evaluations), recorded in stats
+	typename ProblemType::fitness_type tire(RNGType& rng, size_t scout_evaluations, PhaseStats& stats, TracingPolicy& tracing) {
+		if constexpr (is_adaptive_mixing_strategy<MixingStrategy>::value) {
+			mixing_strategy.end_cycle();
+		}
+		improved_this_cycle = false;
+
 		if (remaining_cycles == 0) {
-			problem.randomize_value(rng);
+			Stopwatch stopwatch;
+			//the opposition-based initialization evaluates the solution itself
+			std::optional<typename ProblemType::fitness_type> initial_fitness = problem.randomize_value(rng);
+			stopwatch.lap(stats.mixing_ns);
+
 			typename ProblemType::fitness_type old_fitness = fitness;
-			fitness = problem.compute_fitness();
+			tracing.begin("evaluate");
+			fitness = initial_fitness ? *initial_fitness : problem.compute_fitness();
+			tracing.end("evaluate");
+			stopwatch.lap(stats.evaluation_ns);
+			stats.record_evaluation(scout_evaluations);
 			remaining_cycles = limit;
+			cycles_since_improvement = 0;
+			mean_interval = 1;
 
 			return fitness - old_fitness;
 		}
@@ -134,16 +387,96 @@ public:
 		}
 	}
 
+	/*
+	Runs n_iterations of ProblemType::refine on a copy of the solution and keeps the copy if it is fitter, returning the
+	change of fitness like explore.
+	*/
+	template <typename TracingPolicy>
+	typename ProblemType::fitness_type refine(size_t n_iterations, PhaseStats& stats, TracingPolicy& tracing) {
+		Stopwatch stopwatch;
+		ProblemType refined(problem);
+		refined.refine(n_iterations);
+		stopwatch.lap(stats.mixing_ns);
+
+		tracing.begin("evaluate");
+		typename ProblemType::fitness_type new_fitness = refined.compute_fitness();
+		tracing.end("evaluate");
+		stopwatch.lap(stats.evaluation_ns);
+
+		stats.record_trial(new_fitness > fitness);
+		if (new_fitness > fitness) {
+			problem = std::move(refined);
+			remaining_cycles = limit;
+			improved_this_cycle = true;
+
+			typename ProblemType::fitness_type delta = new_fitness - fitness;
+			fitness = new_fitness;
+			return delta;
+		}
+		else {
+			return 0;
+		}
+	}
+
 	const ProblemType& get_state() const {
 		return problem;
 	}
 
+	//extends the solution to vectors appended to the dataset and re-evaluates it
+	void append_vectors(const typename ProblemType::params_type& params) {
+		problem.append_vectors(params);
+		fitness = problem.compute_fitness();
+	}
+
+	/*
+	Updates the mean interval between improvements with the outcome of the cycle and derives the limit from it, see
+	AdaptiveLimit. The cycles already spent without an improvement count against the new limit. Called before tire.
+	*/
+	void adapt_limit(const AdaptiveLimit& adaptive) noexcept {
+		++cycles_since_improvement;
+		if (improved_this_cycle) {
+			mean_interval += (cycles_since_improvement - mean_interval) * adaptive.decay;
+			cycles_since_improvement = 0;
+		}
+
+		const double expected = adaptive.patience * mean_interval;
+		const size_t new_limit = static_cast<size_t>(std::clamp(std::ceil(expected), static_cast<double>(adaptive.min_limit), static_cast<double>(adaptive.max_limit)));
+		const size_t stale_cycles = limit - remaining_cycles;
+		limit = new_limit;
+		remaining_cycles = limit > stale_cycles ? limit - stale_cycles : 0;
+	}
+
+	//whether the next call to tire will abandon the food source
+	bool exhausted() const noexcept {
+		return remaining_cycles == 0;
+	}
+
+	size_t get_limit() const noexcept {
+		return limit;
+	}
+
+	size_t get_remaining_cycles() const noexcept {
+		return remaining_cycles;
+	}
+
+	const MixingStrategy& get_mixing_strategy() const noexcept {
+		return mixing_strategy;
+	}
+
+	CheckpointBeeEntry get_checkpoint_entry() const noexcept {
+		return CheckpointBeeEntry{ limit, remaining_cycles, static_cast<double>(fitness), cycles_since_improvement, mean_interval, improved_this_cycle };
+	}
+
 private:
 	ProblemType problem;;
 	size_t limit;
 	size_t remaining_cycles;
 	typename ProblemType::fitness_type fitness;
 	MixingStrategy mixing_strategy;
+	bool improved_this_cycle;
+	//see AdaptiveLimit
+	size_t cycles_since_improvement;
+	double mean_interval;
 };
 
 class RouletteSelectionStrategy {
@@ -168,13 +501,9 @@ public:
 	size_t select(FitnessType, const std::vector<BeeType>& swarm, const size_t iteration, RNGType& rng) {
 		size_t tournament_size = compute_size(iteration);
 
-		static std::vector<size_t> numbers;
-		if (numbers.size() != swarm.size()) {
-			numbers.resize(swarm.size());
-			for (size_t i = 0; i < numbers.size(); ++i) {
-				numbers[i] = i;
-			}
-		}
+		//restarting from the identity keeps the selection a function of the RNG state alone
+		numbers.resize(swarm.size());
+		std::iota(numbers.begin(), numbers.end(), 0);
 
 		size_t winner;
 
@@ -204,6 +533,7 @@ public:
 private:
 	size_t population;
 	size_t max_cycles;
+	std::vector<size_t> numbers;
 
 	size_t compute_size(size_t iteration) {
 		if (population >= 20) {
@@ -235,67 +565,470 @@ private:
 	}
 };
 
+//DEMixingStrategy mixes a bee with 3 others
+inline void check_population(size_t population) {
+	if (population < 4) {
+		throw std::invalid_argument("the population must be at least 4");
+	}
+}
+
+/*
+A new solution set by ProblemType::randomize_value and its fitness, which is only computed when the initialization has
+not done so already; initialization_evaluations gives the number of evaluations it took. ProblemType needs
+value_size(params) and a constructor taking the parameters and a value, like ArtificialBeeColony::load.
+*/
+template <typename ProblemType, typename RNGType>
+std::pair<ProblemType, typename ProblemType::fitness_type> random_solution(const typename ProblemType::params_type& params, RNGType& rng) {
+	using value_type = typename std::decay_t<decltype(std::declval<ProblemType>().get_value())>::value_type;
+
+	ProblemType problem(params, std::vector<value_type>(ProblemType::value_size(params)));
+	std::optional<typename ProblemType::fitness_type> fitness = problem.randomize_value(rng);
+	if (!fitness) {
+		fitness = problem.compute_fitness();
+	}
+	return { std::move(problem), *fitness };
+}
+
 template <typename ProblemType, typename MixingStrategy, typename RNGType>
 std::vector<Bee<ProblemType, MixingStrategy>> generate_population(typename ProblemType::params_type params, size_t limit, size_t size, MixingStrategy mixing_strategy, RNGType& rng) {
+	check_population(size);
 	std::vector<Bee<ProblemType, MixingStrategy>> result;
 	for (size_t i = 0; i < size; ++i) {
-		result.emplace_back(limit, ProblemType(params, rng), mixing_strategy);
+		std::pair<ProblemType, typename ProblemType::fitness_type> solution = random_solution<ProblemType>(params, rng);
+		result.emplace_back(limit, std::move(solution.first), solution.second, mixing_strategy);
 	}
 	return result;
 }
 
+/*
+Memetic refinement of the colony: every period cycles (never when period is 0) the champion and the n_bees fittest bees
+run iterations steps of the local search of the problem type (closed-form fuzzy c-means updates, see
+FuzzyClustering::refine). A refined solution replaces the original only if it is fitter.
+*/
+struct RefinementSchedule {
+	size_t period = 0;
+	size_t iterations = 3;
+	size_t n_bees = 0;
+};
+
 /*
 The class encapsulating the core algorithm logic.
-	ProblemType - class encapsulating the problem; FuzzyClustering (or a custom class exposing suitable interface)
-	MixingStrategy - class encapsulating the mixing strategy; ClassicMixingStrategy or DEMixingStrategy (or a custom class exposing suitable interface)
+	ProblemType - class encapsulating the problem; FuzzyClustering, CentroidFuzzyClustering or SparseFuzzyClustering (or a custom class exposing suitable interface, including a static prepare_params that precomputes shared per-dataset data)
+	MixingStrategy - class encapsulating the mixing strategy; ClassicMixingStrategy, DEMixingStrategy or AdaptiveDEMixingStrategy (or a custom class exposing suitable interface)
 	SelectionStrategy - class encapsulating the selection strategy; RouletteSelectionStrategy or TournamentSelectionStrategy (or a custom class exposing suitable interface)
 	RNGType - a random number generator (one of those defined in the <random> header, or a custom one with the same interface)
+	TracingPolicy - receives begin/end events for cycles, phases and evaluations; NullTracingPolicy or ChromeTracingPolicy
 */
-template <typename ProblemType, typename MixingStrategy, typename SelectionStrategy, typename RNGType>
+template <typename ProblemType, typename MixingStrategy, typename SelectionStrategy, typename RNGType, typename TracingPolicy = NullTracingPolicy>
 class ArtificialBeeColony {
 public:
-	ArtificialBeeColony(typename ProblemType::params_type problem_params, size_t population, size_t limit, MixingStrategy mixing_strategy, SelectionStrategy selection_strategy, RNGType&& rng):
-		rng(std::move(rng)),
+	using problem_type = ProblemType;
+	using mixing_strategy_type = MixingStrategy;
+	using selection_strategy_type = SelectionStrategy;
+	using bee_type = Bee<ProblemType, MixingStrategy>;
+
+	ArtificialBeeColony(typename ProblemType::params_type problem_params, size_t population, size_t limit, MixingStrategy mixing_strategy, SelectionStrategy selection_strategy, RNGType&& rng, TracingPolicy tracing = TracingPolicy()):
+		problem_params(ProblemType::prepare_params(problem_params)),
 		selection_strategy(selection_strategy),
-		problem_params(problem_params),
-		bees(generate_population<ProblemType, MixingStrategy, RNGType>(problem_params, limit, population, mixing_strategy, rng)),
+		rng(std::move(rng)),
+		bees(generate_population<ProblemType, MixingStrategy, RNGType>(this->problem_params, limit, population, mixing_strategy, rng)),
 		champion(*std::max_element(bees.cbegin(), bees.cend(), [](const auto& a, const auto& b) { return a.get_fitness() < b.get_fitness(); })),
-		all_nectar(std::accumulate(bees.cbegin(), bees.cend(), 0.0, [](typename ProblemType::fitness_type a, const auto& b) { return a + b.get_fitness(); })) {
+		all_nectar(std::accumulate(bees.cbegin(), bees.cend(), 0.0, [](typename ProblemType::fitness_type a, const auto& b) { return a + b.get_fitness(); })),
+		evaluations(population * initialization_evaluations(this->problem_params.initialization.get())),
+		tracing(std::move(tracing)),
+		convergence_enabled(false) {
 	}
 
 	void optimize(size_t max_iterations) {
 		selection_strategy.set_size(bees.size(), max_iterations);
+		if (convergence_enabled) {
+			convergence.reserve(convergence.get_records().size() + max_iterations);
+		}
 
 		for (size_t iteration = 0; iteration < max_iterations; ++iteration) {
+			TraceScope<TracingPolicy> cycle_scope(tracing, "cycle");
+
+			tracing.begin("employed");
 			for (size_t i = 0; i < bees.size(); ++i) {
-				all_nectar += bees[i].explore(i, bees, champion, rng);
+				all_nectar += bees[i].explore(i, bees, champion, rng, stats.employed, tracing);
 			}
+			evaluations += bees.size();
+			tracing.end("employed");
 
+			tracing.begin("onlooker");
 			for (size_t i = 0; i < bees.size(); ++i) {
+				Stopwatch stopwatch;
 				size_t source_index = selection_strategy.select(all_nectar, bees, iteration, rng);
+				stopwatch.lap(stats.onlooker.selection_ns);
 
-				all_nectar += bees[source_index].explore(source_index, bees, champion, rng);
+				all_nectar += bees[source_index].explore(source_index, bees, champion, rng, stats.onlooker, tracing);
 			}
+			evaluations += bees.size();
+			tracing.end("onlooker");
 
+			tracing.begin("scout");
+			//the opposition-based initialization evaluates two solutions per scout
+			const size_t scout_evaluations = initialization_evaluations(problem_params.initialization.get());
+			uint64_t abandonments = 0;
 			for (Bee<ProblemType, MixingStrategy>& bee: bees) {
 				if (bee.get_fitness() > champion.get_fitness()) {
 					champion = bee;
+					stats.record_champion_update();
+				}
+
+				if (adaptive_limit.enabled) {
+					bee.adapt_limit(adaptive_limit);
 				}
 
-				all_nectar += bee.tire(rng);
+				if (bee.exhausted()) {
+					evaluations += scout_evaluations;
+					++abandonments;
+				}
+				all_nectar += bee.tire(rng, scout_evaluations, stats.scout, tracing);
+			}
+			stats.record_cycle(abandonments);
+			tracing.end("scout");
+
+			if (refinement.period > 0 && ++cycles_since_refinement >= refinement.period) {
+				tracing.begin("refinement");
+				refine();
+				tracing.end("refinement");
+				cycles_since_refinement = 0;
+			}
+
+			if (convergence_enabled) {
+				convergence.record(champion.get_fitness(), all_nectar / bees.size(), evaluations);
+			}
+
+			if (monitor_period > 0 && ++cycles_since_monitor >= monitor_period) {
+				monitor(*this);
+				cycles_since_monitor = 0;
 			}
 		}
+
+		tracing.finish();
+	}
+
+	//cycles_since_refinement restores the progress towards the next refinement; ProblemType needs a refine(n_iterations)
+	//method whatever the period, since optimize contains the call to it
+	void set_refinement(const RefinementSchedule& schedule, size_t cycles_since_refinement = 0) noexcept {
+		refinement = schedule;
+		this->cycles_since_refinement = cycles_since_refinement;
+	}
+
+	const RefinementSchedule& get_refinement() const noexcept {
+		return refinement;
+	}
+
+	size_t get_cycles_since_refinement() const noexcept {
+		return cycles_since_refinement;
+	}
+
+	//replaces the fixed limit of every bee with one derived from its success rate, see AdaptiveLimit; the limit given to the constructor is the starting one
+	void set_adaptive_limit(const AdaptiveLimit& adaptive) noexcept {
+		adaptive_limit = adaptive;
+	}
+
+	const AdaptiveLimit& get_adaptive_limit() const noexcept {
+		return adaptive_limit;
+	}
+
+	/*
+	Calls monitor with the colony every period cycles (never when period is 0), after the cycle is complete, e.g. to
+	track the quality of the champion against the ground truth (see evaluate_quality in validity.h).
+	*/
+	void set_monitor(size_t period, std::function<void(const ArtificialBeeColony&)> monitor) {
+		monitor_period = monitor ? period : 0;
+		this->monitor = std::move(monitor);
+		cycles_since_monitor = 0;
 	}
 
 	const Bee<ProblemType, MixingStrategy>& get_champion() const noexcept {
 		return champion;
 	}
 
+	const typename ProblemType::params_type& get_problem_params() const noexcept {
+		return problem_params;
+	}
+
+	/*
+	Fuzzy memberships of new points with respect to the clusters of the champion, point by point (n_points by
+	n_clusters). The points are spread over threads, see predict.h.
+	*/
+	template <size_t n_dim, typename Scalar>
+	std::vector<double> transform(const std::vector<std::array<Scalar, n_dim>>& points, double fuzzifier = 2.0) const {
+		std::vector<double> memberships(points.size() * champion.get_state().get_n_clusters());
+		assign_memberships(champion.get_state(), points, fuzzifier, memberships.data());
+		return memberships;
+	}
+
+	//the index of the nearest cluster center of the champion for every point
+	template <size_t n_dim, typename Scalar>
+	std::vector<int64_t> predict(const std::vector<std::array<Scalar, n_dim>>& points) const {
+		std::vector<int64_t> labels(points.size());
+		assign_labels(champion.get_state(), points, labels.data());
+		return labels;
+	}
+
+	/*
+	Appends the points to a copy of the dataset (the vectors of the problem parameters, which stay unchanged) and
+	extends every solution to them, so that optimize continues with the current population instead of starting over.
+	Every solution is evaluated once on the grown dataset; since the fitness values change, the champion is re-elected
+	among the re-evaluated solutions. ProblemType needs a static extend_params and an append_vectors method.
+	*/
+	template <size_t n_dim, typename Scalar>
+	void append_vectors(const std::vector<std::array<Scalar, n_dim>>& points) {
+		//the solutions still read the current vectors (possibly owned by problem_params) while they are extended
+		typename ProblemType::params_type extended_params = ProblemType::extend_params(problem_params, points);
+
+		for (Bee<ProblemType, MixingStrategy>& bee : bees) {
+			bee.append_vectors(extended_params);
+		}
+		champion.append_vectors(extended_params);
+		problem_params = std::move(extended_params);
+		evaluations += bees.size() + 1;
+
+		for (const Bee<ProblemType, MixingStrategy>& bee : bees) {
+			if (bee.get_fitness() > champion.get_fitness()) {
+				champion = bee;
+			}
+		}
+		all_nectar = std::accumulate(bees.cbegin(), bees.cend(), 0.0, [](typename ProblemType::fitness_type a, const auto& b) { return a + b.get_fitness(); });
+	}
+
+	/*
+	Replaces the least fit bee with the solution given by the centers (see assign_from_centers of the problem types),
+	e.g. to seed the colony with the result of a related run. Returns whether the new solution became the champion.
+	*/
+	bool seed_centers(const std::vector<double>& centers) {
+		auto worst = std::min_element(bees.begin(), bees.end(), [](const auto& a, const auto& b) { return a.get_fitness() < b.get_fitness(); });
+		ProblemType problem = worst->get_state();
+		problem.assign_from_centers(centers);
+
+		all_nectar -= worst->get_fitness();
+		*worst = Bee<ProblemType, MixingStrategy>(worst->get_limit(), std::move(problem), worst->get_mixing_strategy());
+		all_nectar += worst->get_fitness();
+		++evaluations;
+
+		if (worst->get_fitness() > champion.get_fitness()) {
+			champion = *worst;
+			stats.record_champion_update();
+			return true;
+		}
+		return false;
+	}
+
+	//counters are only collected when ABC_STATS is enabled, see stats.h
+	const ColonyStats& get_stats() const noexcept {
+		return stats;
+	}
+
+	TracingPolicy& get_tracing() noexcept {
+		return tracing;
+	}
+
+	//the total number of fitness evaluations, including those of the initial population
+	uint64_t get_evaluations() const noexcept {
+		return evaluations;
+	}
+
+	//when enabled, every subsequent cycle appends a record to the convergence trace
+	void record_convergence(bool enabled) noexcept {
+		convergence_enabled = enabled;
+	}
+
+	const ConvergenceTrace& get_convergence() const noexcept {
+		return convergence;
+	}
+
+	void clear_convergence() {
+		convergence.clear();
+	}
+
+	/*
+	Writes the population, the champion, the accumulated fitness, the RNG state, the AdaptiveLimit with the intervals
+	between improvements of every bee and the state of an adaptive mixing strategy in the format described in
+	checkpoint.h. The problem parameters (the dataset) and the parameters of the strategies are not part of the
+	checkpoint. ProblemType needs to expose its solution through get_value().
+	*/
+	void save(std::ostream& out) const {
+		using value_type = typename std::decay_t<decltype(champion.get_state().get_value())>::value_type;
+
+		CheckpointWriter writer(out);
+		write_checkpoint_header(writer, sizeof(value_type));
+		writer.write<uint64_t>(bees.size());
+		writer.write<uint64_t>(champion.get_state().get_value().size());
+		writer.write<uint64_t>(evaluations);
+		writer.write<double>(all_nectar);
+
+		std::ostringstream rng_state;
+		rng_state << rng;
+		writer.write_string(rng_state.str());
+
+		writer.write<uint64_t>(adaptive_limit.enabled);
+		writer.write(adaptive_limit.patience);
+		writer.write(adaptive_limit.decay);
+		writer.write<uint64_t>(adaptive_limit.min_limit);
+		writer.write<uint64_t>(adaptive_limit.max_limit);
+		writer.write<uint64_t>(is_adaptive_mixing_strategy<MixingStrategy>::value);
+
+		for (const Bee<ProblemType, MixingStrategy>* bee : all_bees()) {
+			writer.write(bee->get_checkpoint_entry());
+		}
+		if constexpr (is_adaptive_mixing_strategy<MixingStrategy>::value) {
+			for (const Bee<ProblemType, MixingStrategy>* bee : all_bees()) {
+				bee->get_mixing_strategy().save(writer);
+			}
+		}
+
+		writer.align(checkpoint_alignment);
+		for (const Bee<ProblemType, MixingStrategy>* bee : all_bees()) {
+			writer.write_values(bee->get_state().get_value());
+		}
+	}
+
+	void save(const std::string& path) const {
+		std::ofstream out(path, std::ios::binary);
+		if (!out) {
+			throw std::runtime_error("cannot open " + path + " for writing");
+		}
+		save(out);
+	}
+
+	/*
+	Restores a colony written by save. The problem parameters must describe the same dataset the colony was created
+	with; the strategies are passed in the same way as to the constructor. ProblemType needs a constructor taking the
+	parameters and an rvalue of the value returned by get_value(), and value_size(params) giving the length of that
+	value, against which the checkpoint is checked.
+	*/
+	static ArtificialBeeColony load(std::istream& in, typename ProblemType::params_type problem_params, MixingStrategy mixing_strategy, SelectionStrategy selection_strategy, TracingPolicy tracing = TracingPolicy()) {
+		using value_type = typename std::decay_t<decltype(std::declval<ProblemType>().get_value())>::value_type;
+
+		CheckpointReader reader(in);
+		read_checkpoint_header(reader, sizeof(value_type));
+		uint64_t population = reader.read<uint64_t>();
+		uint64_t values_per_bee = reader.read<uint64_t>();
+		uint64_t evaluations = reader.read<uint64_t>();
+		double all_nectar = reader.read<double>();
+
+		RNGType rng;
+		std::istringstream rng_state(reader.read_string());
+		rng_state >> rng;
+
+		AdaptiveLimit adaptive_limit;
+		adaptive_limit.enabled = reader.read<uint64_t>() != 0;
+		adaptive_limit.patience = reader.read<double>();
+		adaptive_limit.decay = reader.read<double>();
+		adaptive_limit.min_limit = reader.read<uint64_t>();
+		adaptive_limit.max_limit = reader.read<uint64_t>();
+		const bool has_mixing_states = reader.read<uint64_t>() != 0;
+		if (has_mixing_states != is_adaptive_mixing_strategy<MixingStrategy>::value) {
+			throw std::runtime_error(has_mixing_states ? "the checkpoint was written by a colony with adaptive mixing" : "the checkpoint holds no state of the adaptive mixing strategy");
+		}
+
+		problem_params = ProblemType::prepare_params(problem_params);
+		check_population(population);
+		if (values_per_bee != ProblemType::value_size(problem_params)) {
+			throw std::invalid_argument("the checkpoint holds " + std::to_string(values_per_bee) + " values per solution, the dataset and number of clusters need " + std::to_string(ProblemType::value_size(problem_params)));
+		}
+
+		reader.expect(population + 1, sizeof(CheckpointBeeEntry));
+		std::vector<CheckpointBeeEntry> entries;
+		for (uint64_t bee_idx = 0; bee_idx <= population; ++bee_idx) {
+			entries.push_back(reader.read<CheckpointBeeEntry>());
+		}
+
+		std::vector<MixingStrategy> mixing_strategies(entries.size(), mixing_strategy);
+		if constexpr (is_adaptive_mixing_strategy<MixingStrategy>::value) {
+			for (MixingStrategy& bee_strategy : mixing_strategies) {
+				bee_strategy.load(reader);
+			}
+		}
+
+		reader.align(checkpoint_alignment);
+		std::vector<Bee<ProblemType, MixingStrategy>> bees;
+		bees.reserve(entries.size());
+		for (size_t bee_idx = 0; bee_idx < entries.size(); ++bee_idx) {
+			bees.emplace_back(entries[bee_idx], ProblemType(problem_params, reader.read_values<value_type>(values_per_bee)), mixing_strategies[bee_idx]);
+		}
+
+		Bee<ProblemType, MixingStrategy> champion = std::move(bees.back());
+		bees.pop_back();
+
+		ArtificialBeeColony colony(problem_params, std::move(bees), std::move(champion), all_nectar, evaluations, selection_strategy, std::move(rng), std::move(tracing));
+		colony.set_adaptive_limit(adaptive_limit);
+		return colony;
+	}
+
+	static ArtificialBeeColony load(const std::string& path, typename ProblemType::params_type problem_params, MixingStrategy mixing_strategy, SelectionStrategy selection_strategy, TracingPolicy tracing = TracingPolicy()) {
+		std::ifstream in(path, std::ios::binary);
+		if (!in) {
+			throw std::runtime_error("cannot open " + path);
+		}
+		return load(in, problem_params, mixing_strategy, selection_strategy, std::move(tracing));
+	}
+
+	void reset_stats() {
+		stats = ColonyStats();
+	}
+
 private:
-	const typename ProblemType::params_type problem_params;
+	ArtificialBeeColony(typename ProblemType::params_type problem_params, std::vector<Bee<ProblemType, MixingStrategy>>&& bees, Bee<ProblemType, MixingStrategy>&& champion, typename ProblemType::fitness_type all_nectar, uint64_t evaluations, SelectionStrategy selection_strategy, RNGType&& rng, TracingPolicy&& tracing):
+		problem_params(problem_params),
+		selection_strategy(selection_strategy),
+		rng(std::move(rng)),
+		bees(std::move(bees)),
+		champion(std::move(champion)),
+		all_nectar(all_nectar),
+		evaluations(evaluations),
+		tracing(std::move(tracing)),
+		convergence_enabled(false) {
+	}
+
+	//refines the champion and the refinement.n_bees fittest bees, then re-elects the champion
+	void refine() {
+		std::vector<size_t> order(bees.size());
+		std::iota(order.begin(), order.end(), 0);
+		const size_t n_bees = std::min(refinement.n_bees, bees.size());
+		std::partial_sort(order.begin(), order.begin() + n_bees, order.end(), [this](size_t a, size_t b) { return bees[a].get_fitness() > bees[b].get_fitness(); });
+
+		champion.refine(refinement.iterations, stats.refinement, tracing);
+		for (size_t rank = 0; rank < n_bees; ++rank) {
+			Bee<ProblemType, MixingStrategy>& bee = bees[order[rank]];
+			all_nectar += bee.refine(refinement.iterations, stats.refinement, tracing);
+			if (bee.get_fitness() > champion.get_fitness()) {
+				champion = bee;
+				stats.record_champion_update();
+			}
+		}
+		evaluations += n_bees + 1;
+	}
+
+	//the population followed by the champion
+	std::vector<const Bee<ProblemType, MixingStrategy>*> all_bees() const {
+		std::vector<const Bee<ProblemType, MixingStrategy>*> result;
+		for (const Bee<ProblemType, MixingStrategy>& bee : bees) {
+			result.push_back(&bee);
+		}
+		result.push_back(&champion);
+		return result;
+	}
+
+	typename ProblemType::params_type problem_params;
 	SelectionStrategy selection_strategy;
 	RNGType rng;
 	std::vector<Bee<ProblemType, MixingStrategy>> bees;
 	Bee<ProblemType, MixingStrategy> champion;
 	typename ProblemType::fitness_type all_nectar;
+	uint64_t evaluations;
+	ColonyStats stats;
+	TracingPolicy tracing;
+	bool convergence_enabled;
+	ConvergenceTrace convergence;
+	RefinementSchedule refinement;
+	size_t cycles_since_refinement = 0;
+	AdaptiveLimit adaptive_limit;
+	std::function<void(const ArtificialBeeColony&)> monitor;
+	size_t monitor_period = 0;
+	size_t cycles_since_monitor = 0;
 };
@@ -0,0 +1,52 @@
+/*
+Per-cycle convergence trace of a colony: the champion fitness, the mean fitness of the population and the total number
+of fitness evaluations at the end of every cycle.
+*/
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "npy.h"
+
+struct ConvergenceRecord {
+	double champion_fitness;
+	double mean_fitness;
+	uint64_t evaluations;
+};
+
+class ConvergenceTrace {
+public:
+	void reserve(size_t cycles) {
+		records.reserve(cycles);
+	}
+
+	void record(double champion_fitness, double mean_fitness, uint64_t evaluations) {
+		records.push_back(ConvergenceRecord{ champion_fitness, mean_fitness, evaluations });
+	}
+
+	void clear() {
+		records.clear();
+	}
+
+	const std::vector<ConvergenceRecord>& get_records() const noexcept {
+		return records;
+	}
+
+	//a cycles by 3 float64 array: champion fitness, mean fitness, evaluations
+	void write_npy(const std::string& path) const {
+		std::vector<double> data;
+		data.reserve(records.size() * 3);
+		for (const ConvergenceRecord& record : records) {
+			data.push_back(record.champion_fitness);
+			data.push_back(record.mean_fitness);
+			data.push_back(static_cast<double>(record.evaluations));
+		}
+
+		::write_npy(path, data, { records.size(), 3 });
+	}
+
+private:
+	std::vector<ConvergenceRecord> records;
+};
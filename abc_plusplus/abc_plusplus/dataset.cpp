@@ -0,0 +1,157 @@
+#include "dataset.h"
+
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "ground_truth.h"
+#include "npy.h"
+
+namespace {
+	bool ends_with(const std::string& text, const std::string& suffix) {
+		return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+	}
+
+	//an empty text file or an n by 0 array has no dimensionality to divide by
+	size_t check_dimensionality(const std::string& path, size_t n_dim) {
+		if (n_dim == 0) {
+			throw std::runtime_error(path + " holds no vectors");
+		}
+		return n_dim;
+	}
+
+	//the number of float64 values in a .bin file
+	size_t binary_value_count(const std::string& path, size_t n_dim) {
+		if (n_dim == 0) {
+			throw std::invalid_argument("binary datasets need their dimensionality");
+		}
+		std::ifstream in(path, std::ios::binary | std::ios::ate);
+		if (!in) {
+			throw std::runtime_error("cannot open " + path);
+		}
+		size_t n_bytes = static_cast<size_t>(in.tellg());
+		if (n_bytes % (n_dim * sizeof(double)) != 0) {
+			throw std::runtime_error(path + " does not hold a whole number of " + std::to_string(n_dim) + "-dimensional float64 vectors");
+		}
+		return n_bytes / sizeof(double);
+	}
+
+	/*
+	Scans a text matrix with the rules of read_text_matrix, keeping the values of the rows [first_row, end_row) and
+	stopping after them; returns the number of rows scanned and sets n_cols.
+	*/
+	size_t scan_text_rows(const std::string& path, size_t first_row, size_t end_row, size_t& n_cols, std::vector<double>& values) {
+		std::ifstream in(path);
+		if (!in) {
+			throw std::runtime_error("cannot open " + path);
+		}
+
+		size_t n_rows = 0;
+		n_cols = 0;
+		std::vector<double> row_values;
+		for (std::string line; n_rows < end_row && std::getline(in, line);) {
+			std::istringstream row(line);
+			row_values.clear();
+			for (double value; row >> value;) {
+				row_values.push_back(value);
+			}
+			if (!row.eof()) {
+				throw std::runtime_error(path + " has a malformed number");
+			}
+
+			if (row_values.empty()) {
+				continue;
+			}
+			if (n_cols != 0 && row_values.size() != n_cols) {
+				throw std::runtime_error(path + " has rows of different lengths");
+			}
+			n_cols = row_values.size();
+			if (n_rows >= first_row) {
+				values.insert(values.end(), row_values.cbegin(), row_values.cend());
+			}
+			++n_rows;
+		}
+
+		return n_rows;
+	}
+}
+
+DatasetShape read_dataset_shape(const std::string& path, size_t n_dim) {
+	if (ends_with(path, ".npy")) {
+		std::vector<size_t> shape;
+		read_npy_rows(path, 0, 0, shape);
+		if (shape.size() != 2) {
+			throw std::runtime_error(path + " is not a 2-dimensional array");
+		}
+		return { shape[0], check_dimensionality(path, shape[1]) };
+	}
+
+	if (ends_with(path, ".bin")) {
+		return { binary_value_count(path, n_dim) / n_dim, n_dim };
+	}
+
+	std::vector<double> no_values;
+	size_t n_cols;
+	size_t n_rows = scan_text_rows(path, SIZE_MAX, SIZE_MAX, n_cols, no_values);
+	return { n_rows, check_dimensionality(path, n_cols) };
+}
+
+std::vector<double> read_dataset(const std::string& path, size_t& n_dim) {
+	if (ends_with(path, ".npy")) {
+		std::vector<size_t> shape;
+		std::vector<double> result = read_npy(path, shape);
+		if (shape.size() != 2) {
+			throw std::runtime_error(path + " is not a 2-dimensional array");
+		}
+		n_dim = check_dimensionality(path, shape[1]);
+		return result;
+	}
+
+	if (ends_with(path, ".bin")) {
+		std::vector<double> result(binary_value_count(path, n_dim));
+		std::ifstream in(path, std::ios::binary);
+		in.read(reinterpret_cast<char*>(result.data()), result.size() * sizeof(double));
+		if (!in) {
+			throw std::runtime_error("cannot read " + path);
+		}
+		return result;
+	}
+
+	std::vector<double> result = read_text_matrix(path, n_dim);
+	check_dimensionality(path, n_dim);
+	return result;
+}
+
+std::vector<double> read_dataset_vectors(const std::string& path, size_t n_dim, size_t first_vector, size_t n_vectors) {
+	if (ends_with(path, ".npy")) {
+		std::vector<size_t> shape;
+		std::vector<double> result = read_npy_rows(path, first_vector, n_vectors, shape);
+		if (shape.size() != 2) {
+			throw std::runtime_error(path + " is not a 2-dimensional array");
+		}
+		return result;
+	}
+
+	if (ends_with(path, ".bin")) {
+		const size_t total = binary_value_count(path, n_dim) / n_dim;
+		if (first_vector > total || n_vectors > total - first_vector) {
+			throw std::out_of_range("vectors past the end of " + path);
+		}
+		std::vector<double> result(n_vectors * n_dim);
+		std::ifstream in(path, std::ios::binary);
+		in.seekg(static_cast<std::streamoff>(first_vector * n_dim * sizeof(double)));
+		in.read(reinterpret_cast<char*>(result.data()), result.size() * sizeof(double));
+		if (!in) {
+			throw std::runtime_error("cannot read " + path);
+		}
+		return result;
+	}
+
+	std::vector<double> result;
+	size_t n_cols;
+	if (scan_text_rows(path, first_vector, first_vector + n_vectors, n_cols, result) < first_vector + n_vectors) {
+		throw std::out_of_range("vectors past the end of " + path);
+	}
+	return result;
+}
@@ -0,0 +1,29 @@
+/*
+Readers of the dataset files taken by the command line: n by m .npy files, whitespace-separated text with one vector
+per line, or (with the .bin extension) raw little-endian float64 values vector by vector, for which m has to be given.
+Besides reading a whole dataset, the shape and a range of vectors can be read on their own, so that the shards of
+sharded.h each load their own vectors and no process holds the whole dataset. A dataset without any values is
+rejected, so that the dimensionality is always positive.
+*/
+#pragma once
+
+#include <string>
+#include <vector>
+
+struct DatasetShape {
+	size_t n_vectors;
+	size_t n_dim;
+};
+
+//the number of vectors and their dimensionality; n_dim is only used (and required) for .bin files
+DatasetShape read_dataset_shape(const std::string& path, size_t n_dim);
+
+//the values of the whole dataset, vector by vector; n_dim is the given dimensionality for .bin files and is set for the others
+std::vector<double> read_dataset(const std::string& path, size_t& n_dim);
+
+/*
+The values of the vectors [first_vector, first_vector + n_vectors), vector by vector; n_dim as for read_dataset_shape.
+Text files are scanned up to the last of them, the others are read at an offset. Throws std::out_of_range for vectors
+past the end.
+*/
+std::vector<double> read_dataset_vectors(const std::string& path, size_t n_dim, size_t first_vector, size_t n_vectors);
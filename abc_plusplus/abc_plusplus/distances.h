@@ -0,0 +1,431 @@
+/*
+Distance metrics between the vectors of a dataset and cluster centers.
+
+The kernel is a cache-blocked computation of the squared Euclidean distances between a block of vectors and all
+cluster centers, using ||x||^2 + ||c||^2 - 2 x.c. The dot products are computed as a register-tiled matrix product,
+4 vectors by 4 centers at a time, over slices of the dimensions that keep the tiles in the L1 cache.
+
+For fewer than distance_gemm_min_dim dimensions the differences are computed directly instead.
+
+Accuracy: the expansion loses precision through cancellation when a vector is close to a center. The absolute error of
+a squared distance is bounded by about 2 * n_dim * eps * (||x||^2 + ||c||^2) (eps = 2^-53), and negative results are
+clamped to 0. On the bundled datasets fitness values match the direct computation to a relative difference below 1e-9.
+*/
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "util.h"
+
+//the number of vectors processed by one call of squared_distance_block
+constexpr size_t distance_block_size = 64;
+//the number of dimensions of a single slice of the dot products
+constexpr size_t distance_dim_block = 256;
+//below this dimensionality the differences are computed directly, which is both faster and exact
+constexpr size_t distance_gemm_min_dim = 8;
+
+template <size_t n_dim, typename Scalar>
+std::vector<double> compute_squared_norms(const std::vector<std::array<Scalar, n_dim>>& vectors) {
+	std::vector<double> result(vectors.size());
+	for (size_t vector_idx = 0; vector_idx < vectors.size(); ++vector_idx) {
+		double norm = 0.0;
+		for (size_t dimension = 0; dimension < n_dim; ++dimension) {
+			norm += static_cast<double>(vectors[vector_idx][dimension]) * vectors[vector_idx][dimension];
+		}
+		result[vector_idx] = norm;
+	}
+
+	return result;
+}
+
+//squared norms of n_centers centers stored one after another
+template <size_t n_dim>
+void compute_center_norms(const double* centers, size_t n_centers, double* norms) {
+	for (size_t center_idx = 0; center_idx < n_centers; ++center_idx) {
+		double norm = 0.0;
+		for (size_t dimension = 0; dimension < n_dim; ++dimension) {
+			norm += centers[center_idx * n_dim + dimension] * centers[center_idx * n_dim + dimension];
+		}
+		norms[center_idx] = norm;
+	}
+}
+
+/*
+Computes dot products of n_vectors (at most distance_block_size) vectors with n_centers centers and accumulates them
+into out[vector_idx * n_centers + center_idx].
+*/
+template <size_t n_dim, typename Scalar>
+void accumulate_dot_block(const std::array<Scalar, n_dim>* vectors, size_t n_vectors, const double* centers, size_t n_centers, double* out) {
+	for (size_t dim_begin = 0; dim_begin < n_dim; dim_begin += distance_dim_block) {
+		const size_t dim_end = std::min(n_dim, dim_begin + distance_dim_block);
+
+		size_t vector_idx = 0;
+		for (; vector_idx + 4 <= n_vectors; vector_idx += 4) {
+			const Scalar* x0 = vectors[vector_idx].data();
+			const Scalar* x1 = vectors[vector_idx + 1].data();
+			const Scalar* x2 = vectors[vector_idx + 2].data();
+			const Scalar* x3 = vectors[vector_idx + 3].data();
+
+			size_t center_idx = 0;
+			for (; center_idx + 4 <= n_centers; center_idx += 4) {
+				const double* c0 = centers + center_idx * n_dim;
+				const double* c1 = c0 + n_dim;
+				const double* c2 = c1 + n_dim;
+				const double* c3 = c2 + n_dim;
+
+				double acc[4][4] = {};
+				for (size_t dimension = dim_begin; dimension < dim_end; ++dimension) {
+					const double xs[4] = { static_cast<double>(x0[dimension]), static_cast<double>(x1[dimension]), static_cast<double>(x2[dimension]), static_cast<double>(x3[dimension]) };
+					const double cs[4] = { c0[dimension], c1[dimension], c2[dimension], c3[dimension] };
+					for (size_t i = 0; i < 4; ++i) {
+						for (size_t j = 0; j < 4; ++j) {
+							acc[i][j] += xs[i] * cs[j];
+						}
+					}
+				}
+
+				for (size_t i = 0; i < 4; ++i) {
+					for (size_t j = 0; j < 4; ++j) {
+						out[(vector_idx + i) * n_centers + center_idx + j] += acc[i][j];
+					}
+				}
+			}
+
+			//remaining centers, one at a time
+			for (; center_idx < n_centers; ++center_idx) {
+				const double* c = centers + center_idx * n_dim;
+				double acc[4] = {};
+				for (size_t dimension = dim_begin; dimension < dim_end; ++dimension) {
+					acc[0] += x0[dimension] * c[dimension];
+					acc[1] += x1[dimension] * c[dimension];
+					acc[2] += x2[dimension] * c[dimension];
+					acc[3] += x3[dimension] * c[dimension];
+				}
+
+				for (size_t i = 0; i < 4; ++i) {
+					out[(vector_idx + i) * n_centers + center_idx] += acc[i];
+				}
+			}
+		}
+
+		//remaining vectors, one at a time
+		for (; vector_idx < n_vectors; ++vector_idx) {
+			const Scalar* x = vectors[vector_idx].data();
+			for (size_t center_idx = 0; center_idx < n_centers; ++center_idx) {
+				const double* c = centers + center_idx * n_dim;
+				double acc = 0.0;
+				for (size_t dimension = dim_begin; dimension < dim_end; ++dimension) {
+					acc += x[dimension] * c[dimension];
+				}
+				out[vector_idx * n_centers + center_idx] += acc;
+			}
+		}
+	}
+}
+
+/*
+Squared Euclidean distances of n_vectors (at most distance_block_size) consecutive vectors to n_centers centers.
+	vectors, vector_norms - the first vector of the block and its precomputed squared norm
+	centers, center_norms - the centers stored one after another and their squared norms
+	out - n_vectors by n_centers distances, row by row
+*/
+template <size_t n_dim, typename Scalar>
+void squared_distance_block(const std::array<Scalar, n_dim>* vectors, const double* vector_norms, size_t n_vectors, const double* centers, const double* center_norms, size_t n_centers, double* out) {
+	if constexpr (n_dim < distance_gemm_min_dim) {
+		for (size_t vector_idx = 0; vector_idx < n_vectors; ++vector_idx) {
+			for (size_t center_idx = 0; center_idx < n_centers; ++center_idx) {
+				double result = 0.0;
+				for (size_t dimension = 0; dimension < n_dim; ++dimension) {
+					double diff = vectors[vector_idx][dimension] - centers[center_idx * n_dim + dimension];
+					result += diff * diff;
+				}
+				out[vector_idx * n_centers + center_idx] = result;
+			}
+		}
+		return;
+	}
+
+	std::fill(out, out + n_vectors * n_centers, 0.0);
+	accumulate_dot_block(vectors, n_vectors, centers, n_centers, out);
+
+	for (size_t vector_idx = 0; vector_idx < n_vectors; ++vector_idx) {
+		for (size_t center_idx = 0; center_idx < n_centers; ++center_idx) {
+			double& value = out[vector_idx * n_centers + center_idx];
+			value = std::max(0.0, vector_norms[vector_idx] + center_norms[center_idx] - 2.0 * value);
+		}
+	}
+}
+
+/*
+The metric policies of the problem types. A metric is constructed once from the dataset (the colony does that through
+the prepare_params of the problem type) and then shared by all solutions; the per-dataset quantities it needs, such as
+norms or inverse variances, are computed in the constructor. Every metric provides:
+	is_squared - whether the metric behaves like a squared distance, which determines the exponent of the memberships
+	for_vectors(vectors) - a metric for other vectors (e.g. new points to be assigned) that keeps the dataset statistics
+	prepare_centers(centers, n_centers) - per-evaluation preprocessing of n_centers centers stored one after another
+	distance(vector_idx, vector, centers, center_idx) - the distance of a single vector to a single center
+	distance_block(first_vector_idx, vectors, n_vectors, centers, out) - distances of n_vectors (at most
+		distance_block_size) consecutive vectors to all centers, n_vectors by n_centers, row by row
+*/
+
+//centers along with the per-center quantities computed by a metric
+struct PreparedCenters {
+	const double* centers;
+	size_t n_centers;
+	//the centers transformed into the operands of the dot products, empty when the centers themselves are used
+	std::vector<double> operands;
+	std::vector<double> terms;
+
+	const double* dot_operands() const noexcept {
+		return operands.empty() ? centers : operands.data();
+	}
+};
+
+//the squared Euclidean distance, which makes FuzzyClustering minimize the classic fuzzy c-means objective
+class SquaredEuclideanMetric {
+public:
+	static constexpr bool is_squared = true;
+
+	template <size_t n_dim, typename Scalar>
+	explicit SquaredEuclideanMetric(const std::vector<std::array<Scalar, n_dim>>& vectors):
+		squared_norms(compute_squared_norms(vectors)) {
+
+	}
+
+	template <size_t n_dim, typename Scalar>
+	SquaredEuclideanMetric for_vectors(const std::vector<std::array<Scalar, n_dim>>& vectors) const {
+		return SquaredEuclideanMetric(vectors);
+	}
+
+	template <size_t n_dim>
+	PreparedCenters prepare_centers(const double* centers, size_t n_centers) const {
+		PreparedCenters result{ centers, n_centers, {}, std::vector<double>(n_centers) };
+		compute_center_norms<n_dim>(centers, n_centers, result.terms.data());
+		return result;
+	}
+
+	template <size_t n_dim, typename Scalar>
+	double distance(size_t, const std::array<Scalar, n_dim>& vector, const PreparedCenters& centers, size_t center_idx) const {
+		return squared_euclidean_dist(vector.cbegin(), vector.cend(), centers.centers + center_idx * n_dim);
+	}
+
+	template <size_t n_dim, typename Scalar>
+	void distance_block(size_t first_vector_idx, const std::array<Scalar, n_dim>* vectors, size_t n_vectors, const PreparedCenters& centers, double* out) const {
+		squared_distance_block(vectors, squared_norms.data() + first_vector_idx, n_vectors, centers.centers, centers.terms.data(), centers.n_centers, out);
+	}
+
+private:
+	std::vector<double> squared_norms;
+};
+
+//the Euclidean distance, the metric of the original algorithm
+class EuclideanMetric : public SquaredEuclideanMetric {
+public:
+	static constexpr bool is_squared = false;
+
+	using SquaredEuclideanMetric::SquaredEuclideanMetric;
+
+	template <size_t n_dim, typename Scalar>
+	EuclideanMetric for_vectors(const std::vector<std::array<Scalar, n_dim>>& vectors) const {
+		return EuclideanMetric(vectors);
+	}
+
+	template <size_t n_dim, typename Scalar>
+	double distance(size_t vector_idx, const std::array<Scalar, n_dim>& vector, const PreparedCenters& centers, size_t center_idx) const {
+		return std::sqrt(SquaredEuclideanMetric::distance(vector_idx, vector, centers, center_idx));
+	}
+
+	template <size_t n_dim, typename Scalar>
+	void distance_block(size_t first_vector_idx, const std::array<Scalar, n_dim>* vectors, size_t n_vectors, const PreparedCenters& centers, double* out) const {
+		SquaredEuclideanMetric::distance_block(first_vector_idx, vectors, n_vectors, centers, out);
+		for (size_t i = 0; i < n_vectors * centers.n_centers; ++i) {
+			out[i] = std::sqrt(out[i]);
+		}
+	}
+};
+
+/*
+The cosine distance 1 - x.c / (||x|| ||c||). The dataset is normalized implicitly through the precomputed inverse norms
+of the vectors, so it does not have to be normalized beforehand. Zero vectors and centers are at distance 1 from
+everything.
+*/
+class CosineMetric {
+public:
+	//for unit vectors the cosine distance is half of the squared Euclidean distance
+	static constexpr bool is_squared = true;
+
+	template <size_t n_dim, typename Scalar>
+	explicit CosineMetric(const std::vector<std::array<Scalar, n_dim>>& vectors):
+		inverse_norms(compute_squared_norms(vectors)) {
+
+		for (double& norm : inverse_norms) {
+			norm = norm > 0.0 ? 1.0 / std::sqrt(norm) : 0.0;
+		}
+	}
+
+	template <size_t n_dim, typename Scalar>
+	CosineMetric for_vectors(const std::vector<std::array<Scalar, n_dim>>& vectors) const {
+		return CosineMetric(vectors);
+	}
+
+	template <size_t n_dim>
+	PreparedCenters prepare_centers(const double* centers, size_t n_centers) const {
+		PreparedCenters result{ centers, n_centers, std::vector<double>(centers, centers + n_centers * n_dim), std::vector<double>(n_centers) };
+		compute_center_norms<n_dim>(centers, n_centers, result.terms.data());
+		for (size_t center_idx = 0; center_idx < n_centers; ++center_idx) {
+			double inverse_norm = result.terms[center_idx] > 0.0 ? 1.0 / std::sqrt(result.terms[center_idx]) : 0.0;
+			for (size_t dimension = 0; dimension < n_dim; ++dimension) {
+				result.operands[center_idx * n_dim + dimension] *= inverse_norm;
+			}
+		}
+
+		return result;
+	}
+
+	template <size_t n_dim, typename Scalar>
+	double distance(size_t vector_idx, const std::array<Scalar, n_dim>& vector, const PreparedCenters& centers, size_t center_idx) const {
+		const double* operand = centers.operands.data() + center_idx * n_dim;
+		double dot = 0.0;
+		for (size_t dimension = 0; dimension < n_dim; ++dimension) {
+			dot += vector[dimension] * operand[dimension];
+		}
+
+		return std::clamp(1.0 - inverse_norms[vector_idx] * dot, 0.0, 2.0);
+	}
+
+	template <size_t n_dim, typename Scalar>
+	void distance_block(size_t first_vector_idx, const std::array<Scalar, n_dim>* vectors, size_t n_vectors, const PreparedCenters& centers, double* out) const {
+		std::fill(out, out + n_vectors * centers.n_centers, 0.0);
+		accumulate_dot_block(vectors, n_vectors, centers.operands.data(), centers.n_centers, out);
+
+		for (size_t vector_idx = 0; vector_idx < n_vectors; ++vector_idx) {
+			for (size_t center_idx = 0; center_idx < centers.n_centers; ++center_idx) {
+				double& value = out[vector_idx * centers.n_centers + center_idx];
+				value = std::clamp(1.0 - inverse_norms[first_vector_idx + vector_idx] * value, 0.0, 2.0);
+			}
+		}
+	}
+
+private:
+	std::vector<double> inverse_norms;
+};
+
+/*
+The squared Mahalanobis distance with a diagonal covariance matrix, sum_d (x_d - c_d)^2 / var_d, where var_d is the
+variance of dimension d over the dataset. Dimensions with zero variance are ignored.
+*/
+class DiagonalMahalanobisMetric {
+public:
+	static constexpr bool is_squared = true;
+
+	template <size_t n_dim, typename Scalar>
+	explicit DiagonalMahalanobisMetric(const std::vector<std::array<Scalar, n_dim>>& vectors):
+		inverse_variances(n_dim),
+		weighted_norms(vectors.size()) {
+
+		std::vector<double> means(n_dim);
+		for (const std::array<Scalar, n_dim>& vector : vectors) {
+			for (size_t dimension = 0; dimension < n_dim; ++dimension) {
+				means[dimension] += vector[dimension];
+			}
+		}
+		for (double& mean : means) {
+			mean /= vectors.size();
+		}
+
+		for (const std::array<Scalar, n_dim>& vector : vectors) {
+			for (size_t dimension = 0; dimension < n_dim; ++dimension) {
+				inverse_variances[dimension] += (vector[dimension] - means[dimension]) * (vector[dimension] - means[dimension]);
+			}
+		}
+		for (double& variance : inverse_variances) {
+			variance = variance > 0.0 ? vectors.size() / variance : 0.0;
+		}
+
+		compute_weighted_norms(vectors);
+	}
+
+	//the variances stay those of the dataset the metric was built from
+	template <size_t n_dim, typename Scalar>
+	DiagonalMahalanobisMetric for_vectors(const std::vector<std::array<Scalar, n_dim>>& vectors) const {
+		DiagonalMahalanobisMetric result(inverse_variances, vectors.size());
+		result.compute_weighted_norms(vectors);
+		return result;
+	}
+
+	//the operands are the centers scaled by the inverse variances, so that x.operand = sum_d x_d c_d / var_d
+	template <size_t n_dim>
+	PreparedCenters prepare_centers(const double* centers, size_t n_centers) const {
+		PreparedCenters result{ centers, n_centers, std::vector<double>(n_centers * n_dim), std::vector<double>(n_centers) };
+		for (size_t center_idx = 0; center_idx < n_centers; ++center_idx) {
+			double norm = 0.0;
+			for (size_t dimension = 0; dimension < n_dim; ++dimension) {
+				double value = centers[center_idx * n_dim + dimension];
+				result.operands[center_idx * n_dim + dimension] = inverse_variances[dimension] * value;
+				norm += inverse_variances[dimension] * value * value;
+			}
+			result.terms[center_idx] = norm;
+		}
+
+		return result;
+	}
+
+	template <size_t n_dim, typename Scalar>
+	double distance(size_t, const std::array<Scalar, n_dim>& vector, const PreparedCenters& centers, size_t center_idx) const {
+		const double* center = centers.centers + center_idx * n_dim;
+		double result = 0.0;
+		for (size_t dimension = 0; dimension < n_dim; ++dimension) {
+			double diff = vector[dimension] - center[dimension];
+			result += inverse_variances[dimension] * diff * diff;
+		}
+
+		return result;
+	}
+
+	template <size_t n_dim, typename Scalar>
+	void distance_block(size_t first_vector_idx, const std::array<Scalar, n_dim>* vectors, size_t n_vectors, const PreparedCenters& centers, double* out) const {
+		if constexpr (n_dim < distance_gemm_min_dim) {
+			for (size_t vector_idx = 0; vector_idx < n_vectors; ++vector_idx) {
+				for (size_t center_idx = 0; center_idx < centers.n_centers; ++center_idx) {
+					out[vector_idx * centers.n_centers + center_idx] = distance(first_vector_idx + vector_idx, vectors[vector_idx], centers, center_idx);
+				}
+			}
+			return;
+		}
+
+		std::fill(out, out + n_vectors * centers.n_centers, 0.0);
+		accumulate_dot_block(vectors, n_vectors, centers.operands.data(), centers.n_centers, out);
+
+		for (size_t vector_idx = 0; vector_idx < n_vectors; ++vector_idx) {
+			for (size_t center_idx = 0; center_idx < centers.n_centers; ++center_idx) {
+				double& value = out[vector_idx * centers.n_centers + center_idx];
+				value = std::max(0.0, weighted_norms[first_vector_idx + vector_idx] + centers.terms[center_idx] - 2.0 * value);
+			}
+		}
+	}
+
+private:
+	std::vector<double> inverse_variances;
+	std::vector<double> weighted_norms;
+
+	DiagonalMahalanobisMetric(const std::vector<double>& inverse_variances, size_t n_vectors):
+		inverse_variances(inverse_variances),
+		weighted_norms(n_vectors) {
+
+	}
+
+	template <size_t n_dim, typename Scalar>
+	void compute_weighted_norms(const std::vector<std::array<Scalar, n_dim>>& vectors) {
+		for (size_t vector_idx = 0; vector_idx < vectors.size(); ++vector_idx) {
+			double norm = 0.0;
+			for (size_t dimension = 0; dimension < n_dim; ++dimension) {
+				norm += inverse_variances[dimension] * vectors[vector_idx][dimension] * vectors[vector_idx][dimension];
+			}
+			weighted_norms[vector_idx] = norm;
+		}
+	}
+};
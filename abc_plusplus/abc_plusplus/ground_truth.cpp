@@ -0,0 +1,62 @@
+#include "ground_truth.h"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+std::vector<int64_t> read_partition(const std::string& path) {
+	std::ifstream in(path);
+	if (!in) {
+		throw std::runtime_error("cannot open " + path);
+	}
+
+	std::string line;
+	while (std::getline(in, line) && line.compare(0, 5, "-----") != 0) {
+	}
+	if (!in) {
+		throw std::runtime_error(path + " has no line of dashes ending the header");
+	}
+
+	std::vector<int64_t> labels;
+	for (int64_t label; in >> label;) {
+		if (label < 1) {
+			throw std::runtime_error(path + " has a label smaller than 1");
+		}
+		labels.push_back(label - 1);
+	}
+	if (!in.eof()) {
+		throw std::runtime_error(path + " has a malformed label");
+	}
+
+	return labels;
+}
+
+std::vector<double> read_text_matrix(const std::string& path, size_t& n_cols) {
+	std::ifstream in(path);
+	if (!in) {
+		throw std::runtime_error("cannot open " + path);
+	}
+
+	std::vector<double> values;
+	n_cols = 0;
+	for (std::string line; std::getline(in, line);) {
+		std::istringstream row(line);
+		size_t row_cols = 0;
+		for (double value; row >> value; ++row_cols) {
+			values.push_back(value);
+		}
+		if (!row.eof()) {
+			throw std::runtime_error(path + " has a malformed number");
+		}
+
+		if (row_cols == 0) {
+			continue;
+		}
+		if (n_cols != 0 && row_cols != n_cols) {
+			throw std::runtime_error(path + " has rows of different lengths");
+		}
+		n_cols = row_cols;
+	}
+
+	return values;
+}
@@ -0,0 +1,18 @@
+/*
+Readers for the ground truth files of the datasets in the data directory:
+	*.pa - partitions in the VQ PARTITIONING format: a header ending with a line of dashes, followed by the 1-based
+		cluster label of every vector, one per line
+	*_centroids.txt - the true cluster centers as whitespace-separated text, one center per line
+The fuzzy ground truths (*-fuzzy_gt.npy) are read with read_npy, see npy.h.
+*/
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//the labels of a .pa file, converted to 0-based
+std::vector<int64_t> read_partition(const std::string& path);
+
+//a matrix of whitespace-separated numbers, row by row; n_cols is set to the length of the rows, which must all match
+std::vector<double> read_text_matrix(const std::string& path, size_t& n_cols);
@@ -0,0 +1,200 @@
+/*
+Initialization of solutions, used both for the initial population and for the restarts of scout bees. The problem types
+hold a shared Initialization (in their params) and delegate randomize_value to initialize_solution.
+	uniform - uniformly random memberships (or, for the centroid encoding, centers at random vectors)
+	kmeans_plus_plus - k-means++ seeding of the centers with the metric of the problem, converted to memberships
+	opposition - opposition-based initialization: a uniform solution and its opposite are evaluated and the better one
+		is kept, which costs two fitness evaluations per solution
+	warm_start - user-supplied centers (or a membership matrix, from which centers are derived), perturbed by gaussian
+		noise so that the population is not made of identical solutions
+*/
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "distances.h"
+
+enum class InitializationMethod {
+	uniform,
+	kmeans_plus_plus,
+	opposition,
+	warm_start
+};
+
+struct Initialization {
+	InitializationMethod method = InitializationMethod::uniform;
+	//warm start centers, cluster by cluster
+	std::vector<double> warm_centers;
+	//warm start membership matrix, cluster by cluster as in FuzzyClustering; only used when warm_centers is empty
+	std::vector<double> warm_memberships;
+	//the standard deviation of the noise added to the warm start centers, relative to that of each dimension
+	double perturbation = 0.1;
+	//the standard deviations of the dimensions of the dataset, filled in by prepare
+	std::vector<double> scales;
+
+	//derives the warm start centers and the scales from the dataset
+	template <size_t n_dim, typename Scalar>
+	void prepare(const std::vector<std::array<Scalar, n_dim>>& vectors, size_t n_clusters) {
+		if (method != InitializationMethod::warm_start || !scales.empty()) {
+			return;
+		}
+
+		if (warm_centers.empty()) {
+			if (warm_memberships.size() != n_clusters * vectors.size()) {
+				throw std::invalid_argument("warm start needs n_clusters * n_dim centers or n_clusters * n_vectors memberships");
+			}
+
+			warm_centers.assign(n_clusters * n_dim, 0.0);
+			for (size_t cluster_idx = 0; cluster_idx < n_clusters; ++cluster_idx) {
+				const double* cluster_weights = warm_memberships.data() + cluster_idx * vectors.size();
+				double* center = warm_centers.data() + cluster_idx * n_dim;
+				double weight_sum = 0.0;
+				for (size_t vector_idx = 0; vector_idx < vectors.size(); ++vector_idx) {
+					for (size_t dimension = 0; dimension < n_dim; ++dimension) {
+						center[dimension] += cluster_weights[vector_idx] * vectors[vector_idx][dimension];
+					}
+					weight_sum += cluster_weights[vector_idx];
+				}
+				for (size_t dimension = 0; dimension < n_dim; ++dimension) {
+					center[dimension] /= weight_sum;
+				}
+			}
+			warm_memberships.clear();
+		}
+		else if (warm_centers.size() != n_clusters * n_dim) {
+			throw std::invalid_argument("warm start needs n_clusters * n_dim centers or n_clusters * n_vectors memberships");
+		}
+
+		std::vector<double> means(n_dim);
+		for (const std::array<Scalar, n_dim>& vector : vectors) {
+			for (size_t dimension = 0; dimension < n_dim; ++dimension) {
+				means[dimension] += vector[dimension];
+			}
+		}
+		for (double& mean : means) {
+			mean /= vectors.size();
+		}
+
+		scales.assign(n_dim, 0.0);
+		for (const std::array<Scalar, n_dim>& vector : vectors) {
+			for (size_t dimension = 0; dimension < n_dim; ++dimension) {
+				scales[dimension] += (vector[dimension] - means[dimension]) * (vector[dimension] - means[dimension]);
+			}
+		}
+		for (double& scale : scales) {
+			scale = std::sqrt(scale / vectors.size());
+		}
+	}
+};
+
+//returns a prepared copy of the initialization (or nullptr for the default uniform one)
+template <size_t n_dim, typename Scalar>
+std::shared_ptr<const Initialization> prepare_initialization(std::shared_ptr<const Initialization> initialization, const std::vector<std::array<Scalar, n_dim>>& vectors, size_t n_clusters) {
+	if (!initialization || initialization->method != InitializationMethod::warm_start || !initialization->scales.empty()) {
+		return initialization;
+	}
+
+	std::shared_ptr<Initialization> result = std::make_shared<Initialization>(*initialization);
+	result->prepare(vectors, n_clusters);
+	return result;
+}
+
+/*
+k-means++ seeding: the first center is a random vector, every following one is a vector drawn with probability
+proportional to its squared distance to the nearest center chosen so far (the distance itself for squared metrics).
+*/
+template <typename Metric, size_t n_dim, typename Scalar, typename RNGType>
+std::vector<double> kmeans_plus_plus_centers(const Metric& metric, const std::vector<std::array<Scalar, n_dim>>& vectors, size_t n_clusters, RNGType& rng) {
+	std::vector<double> centers(n_clusters * n_dim);
+	std::vector<double> weights(vectors.size(), std::numeric_limits<double>::infinity());
+
+	size_t chosen = std::uniform_int_distribution<size_t>(0, vectors.size() - 1)(rng);
+	for (size_t cluster_idx = 0; cluster_idx < n_clusters; ++cluster_idx) {
+		double* center = centers.data() + cluster_idx * n_dim;
+		std::copy(vectors[chosen].cbegin(), vectors[chosen].cend(), center);
+		if (cluster_idx + 1 == n_clusters) {
+			break;
+		}
+
+		PreparedCenters prepared_center = metric.template prepare_centers<n_dim>(center, 1);
+		double weight_sum = 0.0;
+		for (size_t vector_idx = 0; vector_idx < vectors.size(); ++vector_idx) {
+			double distance = metric.distance(vector_idx, vectors[vector_idx], prepared_center, 0);
+			weights[vector_idx] = std::min(weights[vector_idx], Metric::is_squared ? distance : distance * distance);
+			weight_sum += weights[vector_idx];
+		}
+
+		//all vectors coincide with the centers; any of them will do
+		if (weight_sum <= 0.0) {
+			chosen = std::uniform_int_distribution<size_t>(0, vectors.size() - 1)(rng);
+			continue;
+		}
+
+		double target = std::uniform_real_distribution<double>(0.0, weight_sum)(rng);
+		chosen = 0;
+		for (; chosen + 1 < vectors.size(); ++chosen) {
+			target -= weights[chosen];
+			if (target < 0.0) {
+				break;
+			}
+		}
+	}
+
+	return centers;
+}
+
+//the warm start centers with gaussian noise of the configured relative size
+template <typename RNGType>
+std::vector<double> perturbed_warm_centers(const Initialization& initialization, RNGType& rng) {
+	std::vector<double> centers = initialization.warm_centers;
+	std::normal_distribution<double> noise(0.0, initialization.perturbation);
+	for (size_t value_idx = 0; value_idx < centers.size(); ++value_idx) {
+		centers[value_idx] += noise(rng) * initialization.scales[value_idx % initialization.scales.size()];
+	}
+
+	return centers;
+}
+
+//the fitness evaluations of a new solution, counting the one of its bee; the opposition-based initialization evaluates two solutions
+inline size_t initialization_evaluations(const Initialization* initialization) noexcept {
+	return initialization && initialization->method == InitializationMethod::opposition ? 2 : 1;
+}
+
+/*
+Sets the solution according to the initialization. Returns its fitness when the initialization computed it (the
+opposition-based one), so that it is not computed again. ProblemType needs randomize_uniform(rng),
+assign_from_centers(centers) and opposite().
+*/
+template <typename ProblemType, typename Metric, size_t n_dim, typename Scalar, typename RNGType>
+std::optional<typename ProblemType::fitness_type> initialize_solution(ProblemType& problem, const Initialization* initialization, const Metric& metric, const std::vector<std::array<Scalar, n_dim>>& vectors, size_t n_clusters, RNGType& rng) {
+	switch (initialization ? initialization->method : InitializationMethod::uniform) {
+	case InitializationMethod::kmeans_plus_plus:
+		problem.assign_from_centers(kmeans_plus_plus_centers(metric, vectors, n_clusters, rng));
+		return std::nullopt;
+	case InitializationMethod::opposition: {
+		problem.randomize_uniform(rng);
+		ProblemType opposite = problem.opposite();
+		typename ProblemType::fitness_type fitness = problem.compute_fitness();
+		typename ProblemType::fitness_type opposite_fitness = opposite.compute_fitness();
+		if (opposite_fitness > fitness) {
+			problem = std::move(opposite);
+			return opposite_fitness;
+		}
+		return fitness;
+	}
+	case InitializationMethod::warm_start:
+		problem.assign_from_centers(perturbed_warm_centers(*initialization, rng));
+		return std::nullopt;
+	default:
+		problem.randomize_uniform(rng);
+		return std::nullopt;
+	}
+}
@@ -1,36 +1,371 @@
+/*
+Command-line experiment runner: clusters a dataset with one of the colonies from abc.h for a number of seeds, running
+the seeds in parallel, and writes the champion of every run as .npy files.
+
+	abc_plusplus --data=PATH --k=K [--variant=abc|modabc|adaptive-modabc|tournament-abc|tournament-modabc|
+		tournament-adaptive-modabc|async-abc|async-modabc|async-adaptive-modabc] [--population=20] [--limit=100|auto] [--f=0.8] [--mr=0.1] [--cycles=1000] [--seeds=0] [--threads=N] [--init=uniform|kmeans++|opposition]
+		[--dim=M] [--numa=none|interleave|replicate] [--pin=0|1] [--shards=0] [--out=DIR]
+
+The dataset is an n by m .npy file, whitespace-separated text with one vector per line, or (with the .bin extension)
+raw little-endian float64 values vector by vector, in which case --dim gives m. --seeds takes a comma-separated list of
+seeds and ranges, e.g. 0-7,100. --threads defaults to the number of hardware threads; every thread runs one seed at a
+time, except for the asynchronous variants (see async_colony.h), which run the seeds one after another with all threads
+working on the same colony. The adaptive variants adapt f and mr from the starting values given by --f and --mr (see
+AdaptiveDEMixingStrategy in colonies.h), and --limit=auto adapts the limit of every bee (see AdaptiveLimit), which the
+asynchronous variants do not support. --numa places the dataset on the NUMA nodes and --pin=1 pins the threads to CPUs spread
+over the nodes, see numa.h. --shards=N splits the dataset between N worker processes which each read their own part of
+the file and evaluate the fitness on it (see sharded.h); they also hold the memberships of the solutions, so this process
+keeps neither the dataset nor the memberships. It needs --init=uniform or opposition.
+
+For every seed S the output directory receives:
+	seedS_memberships.npy - n by k float64, the memberships of the champion
+	seedS_centers.npy - k by m float64, the cluster centers of the champion
+	seedS_labels.npy - n int64, the cluster with the largest membership of every vector
+	seedS_convergence.npy - cycles by 3 float64, see ConvergenceTrace
+and a tab-separated line with the seed, the fitness of the champion, the number of evaluations and the run time in
+seconds is printed.
+*/
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
 #include <vector>
-#include<array>
 
 #include "abc.h"
+#include "dataset.h"
+#include "npy.h"
+#include "parallel.h"
+
+struct ExperimentOptions {
+	std::string data_path;
+	size_t n_dim = 0;
+	size_t n_clusters = 0;
+	std::string variant = "abc";
+	size_t population = 20;
+	size_t limit = 100;
+	bool adaptive_limit = false;
+	double f = 0.8;
+	double mr = 0.1;
+	size_t cycles = 1000;
+	std::vector<uint64_t> seeds = { 0 };
+	//the default size of the pool, read without starting it (see run_experiment)
+	size_t n_threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+	std::string initialization = "uniform";
+	NumaPlacement placement = NumaPlacement::none;
+	bool pin_threads = false;
+	size_t n_shards = 0;
+	std::string out_dir = ".";
+};
+
+//every seed is a run, so a range beyond this is a typo
+const uint64_t max_seeds = uint64_t(1) << 20;
+
+//parses a comma-separated list of seeds and inclusive ranges, e.g. 0-7,100
+std::vector<uint64_t> parse_seeds(const std::string& text) {
+	std::vector<uint64_t> result;
+	size_t begin = 0;
+	while (begin <= text.size()) {
+		size_t end = std::min(text.find(',', begin), text.size());
+		std::string item = text.substr(begin, end - begin);
+		size_t dash = item.find('-');
+		if (dash == std::string::npos) {
+			result.push_back(std::stoull(item));
+		}
+		else {
+			uint64_t first = std::stoull(item.substr(0, dash));
+			uint64_t last = std::stoull(item.substr(dash + 1));
+			if (last < first) {
+				throw std::invalid_argument("empty range of seeds " + item);
+			}
+			if (last - first >= max_seeds) {
+				throw std::invalid_argument("more than " + std::to_string(max_seeds) + " seeds in " + item);
+			}
+			//counted rather than compared to last, which may be the largest uint64_t
+			for (uint64_t offset = 0; offset <= last - first; ++offset) {
+				result.push_back(first + offset);
+			}
+		}
+		begin = end + 1;
+	}
+
+	return result;
+}
+
+ExperimentOptions parse_options(int argc, char** argv) {
+	ExperimentOptions options;
+	for (int arg_idx = 1; arg_idx < argc; ++arg_idx) {
+		std::string arg = argv[arg_idx];
+		size_t equals = arg.find('=');
+		if (arg.rfind("--", 0) != 0 || equals == std::string::npos) {
+			throw std::invalid_argument("expected --name=value, got " + arg);
+		}
+		std::string name = arg.substr(2, equals - 2);
+		std::string value = arg.substr(equals + 1);
+
+		if (name == "data") {
+			options.data_path = value;
+		}
+		else if (name == "dim") {
+			options.n_dim = std::stoul(value);
+		}
+		else if (name == "k") {
+			options.n_clusters = std::stoul(value);
+		}
+		else if (name == "variant") {
+			options.variant = value;
+		}
+		else if (name == "population") {
+			options.population = std::stoul(value);
+		}
+		else if (name == "limit") {
+			options.adaptive_limit = value == "auto";
+			options.limit = options.adaptive_limit ? AdaptiveLimit().min_limit : std::stoul(value);
+		}
+		else if (name == "f") {
+			options.f = std::stod(value);
+		}
+		else if (name == "mr") {
+			options.mr = std::stod(value);
+		}
+		else if (name == "cycles") {
+			options.cycles = std::stoul(value);
+		}
+		else if (name == "seeds") {
+			options.seeds = parse_seeds(value);
+		}
+		else if (name == "threads") {
+			options.n_threads = std::max<size_t>(std::stoul(value), 1);
+		}
+		else if (name == "init") {
+			options.initialization = value;
+		}
+		else if (name == "numa") {
+			options.placement = parse_numa_placement(value);
+		}
+		else if (name == "pin") {
+			options.pin_threads = std::stoul(value) != 0;
+		}
+		else if (name == "shards") {
+			options.n_shards = std::stoul(value);
+		}
+		else if (name == "out") {
+			options.out_dir = value;
+		}
+		else {
+			throw std::invalid_argument("unknown option --" + name);
+		}
+	}
+
+	if (options.data_path.empty() || options.n_clusters == 0) {
+		throw std::invalid_argument("--data and --k are required");
+	}
+	const std::vector<std::string> variants = { "abc", "modabc", "adaptive-modabc", "tournament-abc", "tournament-modabc", "tournament-adaptive-modabc", "async-abc", "async-modabc", "async-adaptive-modabc" };
+	if (std::find(variants.cbegin(), variants.cend(), options.variant) == variants.cend()) {
+		throw std::invalid_argument("unknown variant " + options.variant + ", expected abc, modabc, adaptive-modabc, tournament-abc, tournament-modabc, tournament-adaptive-modabc, async-abc, async-modabc or async-adaptive-modabc");
+	}
+	if (options.adaptive_limit && options.variant.rfind("async-", 0) == 0) {
+		throw std::invalid_argument("the asynchronous variants do not support --limit=auto");
+	}
+	if (options.population < 4) {
+		throw std::invalid_argument("the population must be at least 4");
+	}
+
+	return options;
+}
+
+std::shared_ptr<const Initialization> make_initialization(const std::string& name) {
+	std::shared_ptr<Initialization> result = std::make_shared<Initialization>();
+	if (name == "uniform") {
+		result->method = InitializationMethod::uniform;
+	}
+	else if (name == "kmeans++") {
+		result->method = InitializationMethod::kmeans_plus_plus;
+	}
+	else if (name == "opposition") {
+		result->method = InitializationMethod::opposition;
+	}
+	else {
+		throw std::invalid_argument("unknown initialization " + name + ", expected uniform, kmeans++ or opposition");
+	}
+
+	return result;
+}
+
+//writes the champion of the run for one seed and prints its line
+template <typename ProblemType>
+void write_run(const ExperimentOptions& options, uint64_t seed, const ProblemType& champion, double fitness, uint64_t evaluations, const ConvergenceTrace& convergence, double seconds, std::mutex& output_mutex) {
+	const size_t n_clusters = options.n_clusters;
+	std::vector<double> memberships = champion.get_memberships();
+	std::vector<double> centers(champion.get_centers());
+	const size_t n_vectors = memberships.size() / n_clusters;
+	std::vector<int64_t> labels(n_vectors);
+	for (size_t vector_idx = 0; vector_idx < n_vectors; ++vector_idx) {
+		const double* vector_memberships = memberships.data() + vector_idx * n_clusters;
+		labels[vector_idx] = std::max_element(vector_memberships, vector_memberships + n_clusters) - vector_memberships;
+	}
+
+	const std::string prefix = options.out_dir + "/seed" + std::to_string(seed) + "_";
+	write_npy(prefix + "memberships.npy", memberships, { n_vectors, n_clusters });
+	write_npy(prefix + "centers.npy", centers, { n_clusters, centers.size() / n_clusters });
+	write_npy(prefix + "labels.npy", labels, { n_vectors });
+	convergence.write_npy(prefix + "convergence.npy");
+
+	std::lock_guard<std::mutex> lock(output_mutex);
+	std::cout << seed << '\t' << fitness << '\t' << evaluations << '\t' << seconds << std::endl;
+}
+
+//runs a colony for one seed and writes its champion
+template <typename ColonyType, typename MixingStrategy, typename SelectionStrategy>
+void run_seed(const typename ColonyType::problem_type::params_type& params, const ExperimentOptions& options, uint64_t seed, MixingStrategy mixing_strategy, SelectionStrategy selection_strategy, std::mutex& output_mutex) {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	ColonyType colony(params, options.population, options.limit, mixing_strategy, selection_strategy, std::mt19937_64(seed));
+	AdaptiveLimit adaptive_limit;
+	adaptive_limit.enabled = options.adaptive_limit;
+	colony.set_adaptive_limit(adaptive_limit);
+	colony.record_convergence(true);
+	colony.optimize(options.cycles);
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	const auto& champion = colony.get_champion();
+	write_run(options, seed, champion.get_state(), champion.get_fitness(), colony.get_evaluations(), colony.get_convergence(), seconds, output_mutex);
+}
+
+//runs an asynchronous colony with all threads for one seed and writes its champion
+template <typename ColonyType, typename MixingStrategy>
+void run_async_seed(const typename ColonyType::problem_type::params_type& params, const ExperimentOptions& options, uint64_t seed, MixingStrategy mixing_strategy, std::mutex& output_mutex) {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	ColonyType colony(params, options.population, options.limit, mixing_strategy, RouletteSelectionStrategy(), std::mt19937_64(seed), options.n_threads);
+	colony.record_convergence(true);
+	colony.optimize(options.cycles);
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	std::shared_ptr<const typename ColonyType::bee_type> champion = colony.get_champion();
+	write_run(options, seed, champion->get_state(), champion->get_fitness(), colony.get_evaluations(), colony.get_convergence(), seconds, output_mutex);
+}
+
+template <size_t n_dim>
+void run_experiment(const ExperimentOptions& options, std::vector<double> values) {
+	using Problem = FuzzyClustering<n_dim>;
+	using Metric = typename Problem::metric_type;
+
+	std::vector<std::array<double, n_dim>> vectors(values.size() / n_dim);
+	for (size_t vector_idx = 0; vector_idx < vectors.size(); ++vector_idx) {
+		std::copy(values.cbegin() + vector_idx * n_dim, values.cbegin() + (vector_idx + 1) * n_dim, vectors[vector_idx].begin());
+	}
+	values.clear();
+	values.shrink_to_fit();
+
+	//the metric and the initialization are prepared once and shared by the colonies of all seeds
+	FuzzyClusteringParams<n_dim> params{ options.n_clusters, &vectors, nullptr, make_initialization(options.initialization), options.placement, nullptr, nullptr, nullptr };
+	if (options.n_shards > 0) {
+		if (options.initialization != "uniform" && options.initialization != "opposition") {
+			throw std::invalid_argument("--shards needs --init=uniform or opposition");
+		}
+
+		//the workers read their vectors from the file; the metric has no dataset statistics, so one built from no vectors serves them all
+		Metric metric(vectors);
+		params.shards = std::make_shared<const ShardedEvaluator<n_dim, double, Metric>>(options.data_path, metric, options.n_shards);
+		params.metric = std::make_shared<const Metric>(metric);
+	}
+
+	//the shard workers are forked above, before the pool starts its threads, so that no lock is held in the children
+	set_thread_count(options.n_threads);
+	set_thread_pinning(options.pin_threads);
+	params = Problem::prepare_params(params);
+
+	std::mutex output_mutex;
+	if (options.variant.rfind("async-", 0) == 0) {
+		for (uint64_t seed : options.seeds) {
+			if (options.variant == "async-abc") {
+				run_async_seed<AsyncABCFuzzyClustering<n_dim>>(params, options, seed, ClassicMixingStrategy<Problem>(), output_mutex);
+			}
+			else if (options.variant == "async-adaptive-modabc") {
+				run_async_seed<AsyncAdaptiveModABCFuzzyClustering<n_dim>>(params, options, seed, AdaptiveDEMixingStrategy<Problem>(options.f, options.mr), output_mutex);
+			}
+			else {
+				run_async_seed<AsyncModABCFuzzyClustering<n_dim>>(params, options, seed, DEMixingStrategy<Problem>(options.f, options.mr), output_mutex);
+			}
+		}
+		return;
+	}
+
+	parallel_for(options.seeds.size(), 1, [&](size_t begin, size_t end) {
+		for (size_t seed_idx = begin; seed_idx < end; ++seed_idx) {
+			const uint64_t seed = options.seeds[seed_idx];
+			if (options.variant == "abc") {
+				run_seed<ABCFuzzyClustering<n_dim>>(params, options, seed, ClassicMixingStrategy<Problem>(), RouletteSelectionStrategy(), output_mutex);
+			}
+			else if (options.variant == "modabc") {
+				run_seed<ModABCFuzzyClustering<n_dim>>(params, options, seed, DEMixingStrategy<Problem>(options.f, options.mr), RouletteSelectionStrategy(), output_mutex);
+			}
+			else if (options.variant == "adaptive-modabc") {
+				run_seed<AdaptiveModABCFuzzyClustering<n_dim>>(params, options, seed, AdaptiveDEMixingStrategy<Problem>(options.f, options.mr), RouletteSelectionStrategy(), output_mutex);
+			}
+			else if (options.variant == "tournament-abc") {
+				run_seed<TournamentABCFuzzyClustering<n_dim>>(params, options, seed, ClassicMixingStrategy<Problem>(), TournamentSelectionStrategy(), output_mutex);
+			}
+			else if (options.variant == "tournament-adaptive-modabc") {
+				run_seed<TournamentAdaptiveModABCFuzzyClustering<n_dim>>(params, options, seed, AdaptiveDEMixingStrategy<Problem>(options.f, options.mr), TournamentSelectionStrategy(), output_mutex);
+			}
+			else {
+				run_seed<TournamentModABCFuzzyClustering<n_dim>>(params, options, seed, DEMixingStrategy<Problem>(options.f, options.mr), TournamentSelectionStrategy(), output_mutex);
+			}
+		}
+	}, options.n_threads);
+}
+
+//the colonies are templated on the dimensionality, so only these are available
+void run_experiment(const ExperimentOptions& options, std::vector<double> values, size_t n_dim) {
+	switch (n_dim) {
+	case 2: run_experiment<2>(options, std::move(values)); break;
+	case 3: run_experiment<3>(options, std::move(values)); break;
+	case 4: run_experiment<4>(options, std::move(values)); break;
+	case 8: run_experiment<8>(options, std::move(values)); break;
+	case 16: run_experiment<16>(options, std::move(values)); break;
+	case 32: run_experiment<32>(options, std::move(values)); break;
+	case 64: run_experiment<64>(options, std::move(values)); break;
+	case 128: run_experiment<128>(options, std::move(values)); break;
+	case 256: run_experiment<256>(options, std::move(values)); break;
+	case 512: run_experiment<512>(options, std::move(values)); break;
+	case 1024: run_experiment<1024>(options, std::move(values)); break;
+	default: throw std::invalid_argument("unsupported dimensionality " + std::to_string(n_dim) + ", expected 2, 3, 4 or a power of 2 up to 1024");
+	}
+}
+
+int main(int argc, char** argv) {
+	try {
+		ExperimentOptions options = parse_options(argc, argv);
+
+		//with shards, the workers read the vectors themselves, see sharded.h
+		size_t n_dim = options.n_dim;
+		std::vector<double> values;
+		size_t n_vectors;
+		if (options.n_shards > 0) {
+			const DatasetShape shape = read_dataset_shape(options.data_path, n_dim);
+			n_dim = shape.n_dim;
+			n_vectors = shape.n_vectors;
+		}
+		else {
+			values = read_dataset(options.data_path, n_dim);
+			n_vectors = values.size() / n_dim;
+		}
+		if (n_vectors < options.n_clusters) {
+			throw std::invalid_argument("fewer vectors than clusters");
+		}
+
+		std::cout << "seed\tfitness\tevaluations\tseconds" << std::endl;
+		run_experiment(options, std::move(values), n_dim);
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
 
-int main() {
-	std::vector<std::array<double, 2>> vec;
-	vec.push_back({ 1, 2 });
-	vec.push_back({ 5, 5 });
-	vec.push_back({ 6, 5 });
-	vec.push_back({ 0, 1 });
-	vec.push_back({ 19, 20 });
-	vec.push_back({ 26, 21 });
-	vec.push_back({ -1, -2 });
-	vec.push_back({ -3, -2 });
-
-	vec.push_back({ 1, 2 });
-	vec.push_back({ 5, 5 });
-	vec.push_back({ 6, 5 });
-	vec.push_back({ 0, 1 });
-	vec.push_back({ 19, 20 });
-	vec.push_back({ 26, 21 });
-	vec.push_back({ -1, -2 });
-	vec.push_back({ -3, -2 });
-	vec.push_back({ 1, 2 });
-	vec.push_back({ 5, 5 });
-	vec.push_back({ 6, 5 });
-	vec.push_back({ 0, 1 });
-
-	FuzzyClusteringParams<2> params;
-	params.n_clusters = 4;
-	params.vectors = &vec;
-	//ModABCFuzzyClustering<2>colony{ params, 20, 200, DEMixingStrategy<FuzzyClustering<2>>(0.8, 0.1), TournamentSelectionStrategy(20, 1000), std::mt19937_64() };
-	ABCFuzzyClustering<2>colony{ params, 20, 200, ClassicMixingStrategy<FuzzyClustering<2>>(), RouletteSelectionStrategy(), std::mt19937_64() };
-	colony.optimize(1000);
-}
\ No newline at end of file
+	return 0;
+}
@@ -0,0 +1,175 @@
+#include "npy.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+	std::string npy_header(const char* descr, const std::vector<size_t>& shape) {
+		std::ostringstream dict;
+		dict << "{'descr': '" << descr << "', 'fortran_order': False, 'shape': (";
+		for (size_t dim : shape) {
+			dict << dim << ", ";
+		}
+		dict << "), }";
+
+		//magic (6) + version (2) + header length (2) + dictionary, padded with spaces and a newline to a multiple of 64
+		std::string header = dict.str();
+		size_t total = 10 + header.size() + 1;
+		header.append((64 - total % 64) % 64, ' ');
+		header.push_back('\n');
+
+		std::string result("\x93NUMPY\x01\x00", 8);
+		result.push_back(static_cast<char>(header.size() & 0xff));
+		result.push_back(static_cast<char>(header.size() >> 8));
+		return result + header;
+	}
+
+	template <typename ValueType>
+	void write_npy_impl(const std::string& path, const char* descr, const std::vector<ValueType>& data, const std::vector<size_t>& shape) {
+		size_t count = 1;
+		for (size_t dim : shape) {
+			count *= dim;
+		}
+		if (count != data.size()) {
+			throw std::invalid_argument("npy shape does not match the number of values");
+		}
+
+		std::ofstream out(path, std::ios::binary);
+		if (!out) {
+			throw std::runtime_error("cannot open " + path + " for writing");
+		}
+
+		std::string header = npy_header(descr, shape);
+		out.write(header.data(), header.size());
+		out.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(ValueType));
+	}
+
+	//the value of a key of the header dictionary, e.g. "'<f8'" for 'descr' or "(3, 4)" for 'shape'
+	std::string header_value(const std::string& header, const std::string& key, const std::string& path) {
+		size_t key_pos = header.find("'" + key + "'");
+		size_t colon_pos = key_pos == std::string::npos ? key_pos : header.find(':', key_pos);
+		if (colon_pos == std::string::npos) {
+			throw std::runtime_error(path + " has no " + key + " in its npy header");
+		}
+
+		size_t begin = header.find_first_not_of(' ', colon_pos + 1);
+		size_t end = header[begin] == '(' ? header.find(')', begin) + 1 : header.find(',', begin);
+		return header.substr(begin, end - begin);
+	}
+
+	template <typename ValueType>
+	void read_values(std::istream& in, std::vector<double>& data) {
+		std::vector<ValueType> values(data.size());
+		in.read(reinterpret_cast<char*>(values.data()), values.size() * sizeof(ValueType));
+		std::copy(values.cbegin(), values.cend(), data.begin());
+	}
+
+	//reads the header and stores the shape, leaving the stream at the first value; returns the size of a value in bytes
+	size_t read_header(std::istream& in, const std::string& path, std::vector<size_t>& shape, std::string& descr) {
+		char preamble[10];
+		in.read(preamble, sizeof(preamble));
+		if (!in || std::string(preamble, 6) != "\x93NUMPY" || (preamble[6] != 1 && preamble[6] != 2)) {
+			throw std::runtime_error(path + " is not an npy file");
+		}
+
+		//version 2 has a 4 byte header length
+		size_t header_length = static_cast<unsigned char>(preamble[8]) | static_cast<unsigned char>(preamble[9]) << 8;
+		if (preamble[6] == 2) {
+			char high[2];
+			in.read(high, sizeof(high));
+			header_length |= static_cast<size_t>(static_cast<unsigned char>(high[0])) << 16 | static_cast<size_t>(static_cast<unsigned char>(high[1])) << 24;
+		}
+
+		std::string header(header_length, ' ');
+		in.read(&header[0], header_length);
+
+		if (header_value(header, "fortran_order", path) != "False") {
+			throw std::runtime_error(path + " is not in C order");
+		}
+
+		shape.clear();
+		std::istringstream shape_stream(header_value(header, "shape", path).substr(1));
+		for (size_t dim; shape_stream >> dim; shape_stream.ignore(1)) {
+			shape.push_back(dim);
+		}
+
+		descr = header_value(header, "descr", path);
+		if (descr == "'<f8'" || descr == "'<i8'") {
+			return 8;
+		}
+		if (descr == "'<f4'" || descr == "'<i4'") {
+			return 4;
+		}
+		throw std::runtime_error(path + " has an unsupported dtype " + descr);
+	}
+
+	//reads data.size() values of the type described by descr, converted to double
+	void read_converted(std::istream& in, const std::string& path, const std::string& descr, std::vector<double>& data) {
+		if (descr == "'<f8'") {
+			read_values<double>(in, data);
+		}
+		else if (descr == "'<f4'") {
+			read_values<float>(in, data);
+		}
+		else if (descr == "'<i8'") {
+			read_values<int64_t>(in, data);
+		}
+		else {
+			read_values<int32_t>(in, data);
+		}
+
+		if (!in) {
+			throw std::runtime_error(path + " is truncated");
+		}
+	}
+}
+
+void write_npy(const std::string& path, const std::vector<double>& data, const std::vector<size_t>& shape) {
+	write_npy_impl(path, "<f8", data, shape);
+}
+
+void write_npy(const std::string& path, const std::vector<int64_t>& data, const std::vector<size_t>& shape) {
+	write_npy_impl(path, "<i8", data, shape);
+}
+
+std::vector<double> read_npy(const std::string& path, std::vector<size_t>& shape) {
+	std::ifstream in(path, std::ios::binary);
+	if (!in) {
+		throw std::runtime_error("cannot open " + path);
+	}
+
+	std::string descr;
+	read_header(in, path, shape, descr);
+	size_t count = 1;
+	for (size_t dim : shape) {
+		count *= dim;
+	}
+
+	std::vector<double> data(count);
+	read_converted(in, path, descr, data);
+	return data;
+}
+
+std::vector<double> read_npy_rows(const std::string& path, size_t first_row, size_t n_rows, std::vector<size_t>& shape) {
+	std::ifstream in(path, std::ios::binary);
+	if (!in) {
+		throw std::runtime_error("cannot open " + path);
+	}
+
+	std::string descr;
+	const size_t value_size = read_header(in, path, shape, descr);
+	if (shape.empty() || first_row > shape[0] || n_rows > shape[0] - first_row) {
+		throw std::out_of_range("rows past the end of " + path);
+	}
+	size_t row_size = 1;
+	for (size_t dim_idx = 1; dim_idx < shape.size(); ++dim_idx) {
+		row_size *= shape[dim_idx];
+	}
+
+	std::vector<double> data(n_rows * row_size);
+	in.seekg(static_cast<std::streamoff>(first_row * row_size * value_size), std::ios::cur);
+	read_converted(in, path, descr, data);
+	return data;
+}
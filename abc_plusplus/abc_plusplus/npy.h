@@ -0,0 +1,27 @@
+/*
+Minimal reader and writer for the NumPy .npy format (version 1.0, C order, little-endian float64 and int64 arrays),
+so that results can be exchanged with the experiment notebooks without going through Python.
+*/
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+//writes a float64 array of the given shape; the product of the shape must equal data.size()
+void write_npy(const std::string& path, const std::vector<double>& data, const std::vector<size_t>& shape);
+
+//writes an int64 array of the given shape; the product of the shape must equal data.size()
+void write_npy(const std::string& path, const std::vector<int64_t>& data, const std::vector<size_t>& shape);
+
+/*
+Reads a C-order array of little-endian float64, float32, int64 or int32 values, converted to double, and stores its
+shape. Throws std::runtime_error for anything else.
+*/
+std::vector<double> read_npy(const std::string& path, std::vector<size_t>& shape);
+
+/*
+Reads the rows [first_row, first_row + n_rows) of an array like read_npy, without reading the others, and stores the
+shape of the whole array; n_rows may be 0 to read the shape only. Throws std::out_of_range for rows past the end.
+*/
+std::vector<double> read_npy_rows(const std::string& path, size_t first_row, size_t n_rows, std::vector<size_t>& shape);
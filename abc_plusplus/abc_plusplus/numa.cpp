@@ -0,0 +1,216 @@
+#include "numa.h"
+
+#include <cstdint>
+#include <fstream>
+#include <new>
+#include <sstream>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <linux/mempolicy.h>
+#else
+#include <cstdlib>
+#endif
+
+namespace {
+	const size_t huge_page_size = size_t(2) << 20;
+
+	struct NumaTopology {
+		//the ids of the nodes with CPUs, which may have gaps
+		std::vector<size_t> node_ids;
+		//the position in node_ids of the node of every CPU
+		std::vector<size_t> cpu_nodes;
+		//all CPUs, alternating between the nodes
+		std::vector<size_t> spread_cpus;
+	};
+
+	//parses a list of CPUs such as 0-3,8-11
+	std::vector<size_t> parse_cpu_list(const std::string& text) {
+		std::vector<size_t> result;
+		std::istringstream in(text);
+		std::string item;
+		while (std::getline(in, item, ',')) {
+			if (item.empty() || item == "\n") {
+				continue;
+			}
+			size_t dash = item.find('-');
+			size_t first = std::stoul(item.substr(0, dash));
+			size_t last = dash == std::string::npos ? first : std::stoul(item.substr(dash + 1));
+			for (size_t cpu = first; cpu <= last; ++cpu) {
+				result.push_back(cpu);
+			}
+		}
+		return result;
+	}
+
+	NumaTopology read_topology() {
+		NumaTopology topology;
+		std::vector<std::vector<size_t>> node_cpus;
+#if defined(__linux__)
+		std::ifstream online("/sys/devices/system/node/online");
+		std::string online_nodes;
+		if (online && std::getline(online, online_nodes)) {
+			for (size_t node_id : parse_cpu_list(online_nodes)) {
+				std::ifstream cpulist("/sys/devices/system/node/node" + std::to_string(node_id) + "/cpulist");
+				std::string cpus;
+				if (!cpulist || !std::getline(cpulist, cpus)) {
+					continue;
+				}
+				std::vector<size_t> parsed = parse_cpu_list(cpus);
+				if (!parsed.empty()) {
+					topology.node_ids.push_back(node_id);
+					node_cpus.push_back(std::move(parsed));
+				}
+			}
+		}
+#endif
+
+		if (topology.node_ids.empty()) {
+			topology.node_ids.push_back(0);
+			node_cpus.emplace_back();
+		}
+
+		for (size_t node = 0; node < node_cpus.size(); ++node) {
+			for (size_t cpu : node_cpus[node]) {
+				topology.cpu_nodes.resize(std::max(topology.cpu_nodes.size(), cpu + 1), 0);
+				topology.cpu_nodes[cpu] = node;
+			}
+		}
+		for (size_t rank = 0; ; ++rank) {
+			bool any = false;
+			for (const std::vector<size_t>& cpus : node_cpus) {
+				if (rank < cpus.size()) {
+					topology.spread_cpus.push_back(cpus[rank]);
+					any = true;
+				}
+			}
+			if (!any) {
+				break;
+			}
+		}
+
+		return topology;
+	}
+
+	const NumaTopology& get_topology() {
+		//never destroyed, the workers of the thread pool may still pin themselves while the program exits
+		static const NumaTopology& topology = *new NumaTopology(read_topology());
+		return topology;
+	}
+
+	size_t round_to_huge_pages(size_t n_bytes) {
+		return (n_bytes + huge_page_size - 1) / huge_page_size * huge_page_size;
+	}
+}
+
+NumaPlacement parse_numa_placement(const std::string& name) {
+	if (name == "none") {
+		return NumaPlacement::none;
+	}
+	if (name == "interleave") {
+		return NumaPlacement::interleave;
+	}
+	if (name == "replicate") {
+		return NumaPlacement::replicate;
+	}
+	throw std::invalid_argument("unknown NUMA placement " + name + ", expected none, interleave or replicate");
+}
+
+size_t numa_node_count() {
+	return get_topology().node_ids.size();
+}
+
+size_t current_numa_node() {
+#if defined(__linux__)
+	const NumaTopology& topology = get_topology();
+	if (topology.node_ids.size() > 1) {
+		int cpu = sched_getcpu();
+		if (cpu >= 0 && static_cast<size_t>(cpu) < topology.cpu_nodes.size()) {
+			return topology.cpu_nodes[cpu];
+		}
+	}
+#endif
+	return 0;
+}
+
+bool pin_thread(size_t thread_idx) {
+#if defined(__linux__)
+	const NumaTopology& topology = get_topology();
+	if (topology.spread_cpus.empty()) {
+		return false;
+	}
+	cpu_set_t cpus;
+	CPU_ZERO(&cpus);
+	CPU_SET(topology.spread_cpus[thread_idx % topology.spread_cpus.size()], &cpus);
+	return sched_setaffinity(0, sizeof(cpus), &cpus) == 0;
+#else
+	(void)thread_idx;
+	return false;
+#endif
+}
+
+void* allocate_numa(size_t n_bytes, NumaPlacement placement, size_t node) {
+#if defined(__linux__)
+	//mmap only aligns to ordinary pages: a huge page more is mapped and the unaligned head and tail are unmapped again,
+	//so that the range madvise and mbind see starts on a huge page and free_numa finds exactly it
+	const size_t mapped_bytes = round_to_huge_pages(n_bytes);
+	void* reserved = mmap(nullptr, mapped_bytes + huge_page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (reserved == MAP_FAILED) {
+		throw std::bad_alloc();
+	}
+	char* reserved_begin = static_cast<char*>(reserved);
+	char* aligned = reinterpret_cast<char*>(round_to_huge_pages(reinterpret_cast<uintptr_t>(reserved_begin)));
+	const size_t head_bytes = aligned - reserved_begin;
+	if (head_bytes > 0) {
+		munmap(reserved_begin, head_bytes);
+	}
+	munmap(aligned + mapped_bytes, huge_page_size - head_bytes);
+	void* data = aligned;
+
+	//both are hints: without transparent huge pages or on a single node the memory is simply ordinary
+	madvise(data, mapped_bytes, MADV_HUGEPAGE);
+	const NumaTopology& topology = get_topology();
+	if (topology.node_ids.size() > 1 && placement != NumaPlacement::none) {
+		const size_t bits_per_word = 8 * sizeof(unsigned long);
+		std::vector<unsigned long> mask(topology.node_ids.back() / bits_per_word + 1, 0);
+		auto add_node = [&](size_t node_id) { mask[node_id / bits_per_word] |= 1UL << (node_id % bits_per_word); };
+		int mode;
+		if (placement == NumaPlacement::interleave) {
+			for (size_t node_id : topology.node_ids) {
+				add_node(node_id);
+			}
+			mode = MPOL_INTERLEAVE;
+		}
+		else {
+			add_node(topology.node_ids[node % topology.node_ids.size()]);
+			mode = MPOL_PREFERRED;
+		}
+		syscall(SYS_mbind, data, mapped_bytes, mode, mask.data(), mask.size() * bits_per_word + 1, 0);
+	}
+
+	return data;
+#else
+	(void)placement;
+	(void)node;
+	void* data = std::calloc(n_bytes, 1);
+	if (data == nullptr) {
+		throw std::bad_alloc();
+	}
+	return data;
+#endif
+}
+
+void free_numa(void* data, size_t n_bytes) {
+	if (data == nullptr) {
+		return;
+	}
+#if defined(__linux__)
+	munmap(data, round_to_huge_pages(n_bytes));
+#else
+	(void)n_bytes;
+	std::free(data);
+#endif
+}
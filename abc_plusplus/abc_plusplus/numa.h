@@ -0,0 +1,109 @@
+/*
+NUMA-aware placement of the dataset. On a machine with several memory nodes, threads evaluating solutions against a
+dataset stored on one node share that node's memory bandwidth and pay the remote latency, which limits the fitness
+evaluation of high-dimensional datasets. DatasetReplicas copies the dataset into memory backed by 2 MB (transparent)
+huge pages, either once per node, every thread reading the copy on the node it runs on (replicate), or once with the
+pages spread round-robin over the nodes (interleave).
+
+The topology is read from /sys/devices/system/node and the pages are placed with mbind, so this only has an effect on
+Linux, where a single-node machine gets one copy on huge pages; elsewhere there is one copy in ordinary memory. Threads started by parallel_for
+can be pinned to CPUs, see set_thread_pinning in parallel.h, so that they keep reading the same copy.
+*/
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+enum class NumaPlacement {
+	none,
+	interleave,
+	replicate,
+};
+
+//"none", "interleave" or "replicate"; throws std::invalid_argument for anything else
+NumaPlacement parse_numa_placement(const std::string& name);
+
+//the number of memory nodes, 1 when the topology is unknown
+size_t numa_node_count();
+
+//the node of the CPU the calling thread currently runs on, 0 when unknown
+size_t current_numa_node();
+
+/*
+Pins the calling thread to a single CPU. Consecutive thread indices go to different nodes, so that a few threads use
+all of the memory bandwidth. Returns false when pinning is not supported.
+*/
+bool pin_thread(size_t thread_idx);
+
+/*
+Allocates n_bytes of zeroed memory, backed by huge pages where possible, on the given node (replicate) or interleaved
+over all nodes (interleave). Never returns nullptr; throws std::bad_alloc instead.
+*/
+void* allocate_numa(size_t n_bytes, NumaPlacement placement, size_t node);
+void free_numa(void* data, size_t n_bytes);
+
+/*
+Copies of the dataset placed according to a NumaPlacement. T is the (trivially copyable) vector type.
+*/
+template <typename T>
+class DatasetReplicas {
+public:
+	static_assert(std::is_trivially_copyable<T>::value, "the vectors must be trivially copyable");
+
+	DatasetReplicas(const std::vector<T>& vectors, NumaPlacement placement):
+		n_vectors(vectors.size()),
+		n_bytes(std::max<size_t>(vectors.size() * sizeof(T), 1)) {
+
+		if (placement == NumaPlacement::none) {
+			throw std::invalid_argument("no placement to replicate the dataset with");
+		}
+
+		const size_t n_copies = placement == NumaPlacement::replicate ? numa_node_count() : 1;
+		try {
+			for (size_t node = 0; node < n_copies; ++node) {
+				copies.push_back(static_cast<T*>(allocate_numa(n_bytes, placement, node)));
+				std::memcpy(copies.back(), vectors.data(), vectors.size() * sizeof(T));
+			}
+		}
+		catch (...) {
+			release();
+			throw;
+		}
+	}
+
+	DatasetReplicas(const DatasetReplicas&) = delete;
+	DatasetReplicas& operator=(const DatasetReplicas&) = delete;
+
+	~DatasetReplicas() {
+		release();
+	}
+
+	//the copy on the node of the calling thread
+	const T* local() const noexcept {
+		return copies.size() == 1 ? copies.front() : copies[current_numa_node() % copies.size()];
+	}
+
+	size_t size() const noexcept {
+		return n_vectors;
+	}
+
+	size_t copy_count() const noexcept {
+		return copies.size();
+	}
+
+private:
+	void release() noexcept {
+		for (T* copy : copies) {
+			free_numa(copy, n_bytes);
+		}
+		copies.clear();
+	}
+
+	size_t n_vectors;
+	size_t n_bytes;
+	std::vector<T*> copies;
+};
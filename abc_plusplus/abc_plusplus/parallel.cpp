@@ -0,0 +1,154 @@
+#include "parallel.h"
+
+#include <iterator>
+
+namespace {
+	//the index of the worker of the calling thread, or none for threads outside the pool
+	const size_t not_a_worker = static_cast<size_t>(-1);
+	thread_local size_t current_worker = not_a_worker;
+}
+
+ThreadPool& ThreadPool::instance() {
+	static ThreadPool pool(std::max<size_t>(std::thread::hardware_concurrency(), 1), false);
+	return pool;
+}
+
+ThreadPool::ThreadPool(size_t n_threads, bool pinned):
+	n_workers(0),
+	pinned(pinned),
+	pending(0),
+	next_queue(0),
+	stopping(false) {
+
+	start(n_threads, pinned);
+}
+
+ThreadPool::~ThreadPool() {
+	stop();
+}
+
+void ThreadPool::resize(size_t n_threads, bool pinned) {
+	std::lock_guard<std::mutex> resizing(resize_mutex);
+	stop();
+
+	//tasks submitted after the old workers returned
+	std::vector<std::function<void()>> leftovers;
+	{
+		std::unique_lock<std::shared_mutex> layout(layout_mutex);
+		for (std::unique_ptr<TaskQueue>& queue : queues) {
+			std::move(queue->tasks.begin(), queue->tasks.end(), std::back_inserter(leftovers));
+		}
+		workers.clear();
+		queues.clear();
+		pending = 0;
+		start(n_threads, pinned);
+	}
+	for (std::function<void()>& task : leftovers) {
+		submit(std::move(task));
+	}
+}
+
+size_t ThreadPool::size() const noexcept {
+	return n_workers + 1;
+}
+
+bool ThreadPool::is_pinned() const noexcept {
+	return pinned;
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+	{
+		std::shared_lock<std::shared_mutex> layout(layout_mutex);
+		if (!queues.empty()) {
+			//a worker keeps its own tasks local, others spread theirs so that concurrent callers are served in turn
+			size_t queue_idx = current_worker != not_a_worker && current_worker < queues.size() ? current_worker : next_queue++ % queues.size();
+			{
+				std::lock_guard<std::mutex> lock(queues[queue_idx]->mutex);
+				queues[queue_idx]->tasks.push_back(std::move(task));
+			}
+			{
+				std::lock_guard<std::mutex> lock(wake_mutex);
+				++pending;
+			}
+			wake.notify_one();
+			return;
+		}
+	}
+
+	task();
+}
+
+//called with layout_mutex held exclusively, or from the constructor
+void ThreadPool::start(size_t n_threads, bool pinned) {
+	this->pinned = pinned;
+	{
+		std::lock_guard<std::mutex> lock(wake_mutex);
+		stopping = false;
+	}
+	n_workers = std::max<size_t>(n_threads, 1) - 1;
+	for (size_t worker_idx = 0; worker_idx < n_workers; ++worker_idx) {
+		queues.push_back(std::make_unique<TaskQueue>());
+	}
+	for (size_t worker_idx = 0; worker_idx < n_workers; ++worker_idx) {
+		workers.emplace_back(&ThreadPool::work, this, worker_idx);
+	}
+}
+
+//lets the workers finish the queued tasks and joins them; the queues are left to the caller
+void ThreadPool::stop() {
+	{
+		std::lock_guard<std::mutex> lock(wake_mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+}
+
+void ThreadPool::work(size_t worker_idx) {
+	current_worker = worker_idx;
+	if (pinned) {
+		//the calling thread of parallel_for counts as thread 0
+		pin_thread(worker_idx + 1);
+	}
+
+	std::function<void()> task;
+	while (true) {
+		if (take(worker_idx, task)) {
+			task();
+			task = nullptr;
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(wake_mutex);
+		wake.wait(lock, [this]() { return pending > 0 || stopping; });
+		if (pending == 0 && stopping) {
+			return;
+		}
+	}
+}
+
+//the newest task of the worker's own queue, or else the oldest task of the next non-empty queue
+bool ThreadPool::take(size_t worker_idx, std::function<void()>& task) {
+	std::shared_lock<std::shared_mutex> layout(layout_mutex);
+	for (size_t offset = 0; offset < queues.size(); ++offset) {
+		TaskQueue& queue = *queues[(worker_idx + offset) % queues.size()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.tasks.empty()) {
+			continue;
+		}
+		if (offset == 0) {
+			task = std::move(queue.tasks.back());
+			queue.tasks.pop_back();
+		}
+		else {
+			task = std::move(queue.tasks.front());
+			queue.tasks.pop_front();
+		}
+		--pending;
+		return true;
+	}
+
+	return false;
+}
@@ -0,0 +1,161 @@
+/*
+Data-parallel loops on a process-wide thread pool. Everything in the library that runs on several threads (assigning
+points to clusters, validity indices, sweeps, restarts, tuning, the asynchronous colony) goes through parallel_for,
+which hands its ranges to the pool instead of starting threads of its own, so several colonies running at once share
+the cores instead of oversubscribing them.
+
+The pool is a work-stealing scheduler: every worker thread has its own queue of tasks, takes the newest task from it
+and, when it is empty, steals the oldest task of another queue. Tasks submitted from outside the pool are spread over
+the queues round-robin, so the loops of concurrent callers are served in turn. A thread waiting in parallel_for works
+through its own ranges, so nested loops and a busy pool never block.
+
+The queues and the workers are guarded by a shared mutex: submitting and taking tasks hold it shared, and resize holds it
+exclusively only to swap in the new queues and workers, so the pool can be resized while other threads use it.
+*/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+#include "numa.h"
+
+class ThreadPool {
+public:
+	//the pool used by parallel_for, with as many threads as the hardware has until resized
+	static ThreadPool& instance();
+
+	ThreadPool(size_t n_threads, bool pinned);
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+	~ThreadPool();
+
+	/*
+	Replaces the workers with n_threads - 1 new ones (the thread calling parallel_for being the last one), pinned to
+	CPUs spread over the NUMA nodes when pinned is true (see pin_thread). Tasks already submitted are finished first,
+	those submitted while the old workers stop are moved to the new ones. Must not be called from a task of the pool.
+	*/
+	void resize(size_t n_threads, bool pinned);
+
+	//the number of threads, including the calling one
+	size_t size() const noexcept;
+
+	bool is_pinned() const noexcept;
+
+	void submit(std::function<void()> task);
+
+private:
+	struct TaskQueue {
+		std::mutex mutex;
+		std::deque<std::function<void()>> tasks;
+	};
+
+	void start(size_t n_threads, bool pinned);
+	void stop();
+	void work(size_t worker_idx);
+	bool take(size_t worker_idx, std::function<void()>& task);
+
+	//serializes resize
+	std::mutex resize_mutex;
+	//exclusive while queues and workers are replaced, shared while they are used
+	mutable std::shared_mutex layout_mutex;
+	std::vector<std::unique_ptr<TaskQueue>> queues;
+	std::vector<std::thread> workers;
+	std::atomic<size_t> n_workers;
+	std::atomic<bool> pinned;
+
+	std::mutex wake_mutex;
+	std::condition_variable wake;
+	std::atomic<size_t> pending;
+	std::atomic<size_t> next_queue;
+	bool stopping;
+};
+
+inline size_t default_thread_count() {
+	return ThreadPool::instance().size();
+}
+
+//sets the number of threads of the pool, at least 1; must not be called from inside parallel_for
+inline void set_thread_count(size_t n_threads) {
+	ThreadPool& pool = ThreadPool::instance();
+	pool.resize(n_threads, pool.is_pinned());
+}
+
+//pins the worker threads to CPUs spread over the NUMA nodes, see pin_thread; off by default, the calling thread is never pinned
+inline void set_thread_pinning(bool enabled) {
+	ThreadPool& pool = ThreadPool::instance();
+	pool.resize(pool.size(), enabled);
+}
+
+/*
+Calls body(begin, end) for consecutive ranges of at most grain items covering [0, n_items). The ranges are handed out
+dynamically to the calling thread and up to n_threads - 1 threads of the pool. The first exception thrown by body is
+rethrown once all threads have finished.
+*/
+template <typename Body>
+void parallel_for(size_t n_items, size_t grain, const Body& body, size_t n_threads = default_thread_count()) {
+	grain = std::max<size_t>(grain, 1);
+	const size_t n_ranges = (n_items + grain - 1) / grain;
+	n_threads = std::min(n_threads, n_ranges);
+
+	if (n_threads <= 1 || ThreadPool::instance().size() <= 1) {
+		for (size_t begin = 0; begin < n_items; begin += grain) {
+			body(begin, std::min(n_items, begin + grain));
+		}
+		return;
+	}
+
+	//shared with the tasks, which may only start once the loop is over; body is only used while ranges are left
+	struct LoopState {
+		std::atomic<size_t> next_range{ 0 };
+		std::atomic<size_t> active{ 0 };
+		std::mutex mutex;
+		std::condition_variable done;
+		std::exception_ptr error;
+	};
+	std::shared_ptr<LoopState> state = std::make_shared<LoopState>();
+
+	auto run_ranges = [state, n_items, grain, n_ranges, &body]() {
+		try {
+			for (size_t range = state->next_range++; range < n_ranges; range = state->next_range++) {
+				body(range * grain, std::min(n_items, (range + 1) * grain));
+			}
+		}
+		catch (...) {
+			std::lock_guard<std::mutex> lock(state->mutex);
+			if (!state->error) {
+				state->error = std::current_exception();
+			}
+			state->next_range = n_ranges;
+		}
+	};
+
+	ThreadPool& pool = ThreadPool::instance();
+	for (size_t task_idx = 1; task_idx < n_threads; ++task_idx) {
+		pool.submit([state, run_ranges]() {
+			++state->active;
+			run_ranges();
+			std::lock_guard<std::mutex> lock(state->mutex);
+			if (--state->active == 0) {
+				state->done.notify_all();
+			}
+		});
+	}
+	run_ranges();
+
+	//every range has been claimed; wait for those still running on the pool
+	std::unique_lock<std::mutex> lock(state->mutex);
+	state->done.wait(lock, [&state]() { return state->active == 0; });
+
+	if (state->error) {
+		std::rethrow_exception(state->error);
+	}
+}
@@ -0,0 +1,106 @@
+/*
+Assignment of new points to the clusters of a fitted solution (usually the champion of a colony, see
+ArtificialBeeColony::transform and ArtificialBeeColony::predict). assign_memberships computes fuzzy c-means memberships
+of the points with respect to the centers of the solution, assign_labels finds the nearest center.
+
+Distances are computed with the metric of the problem type, rebuilt for the new points (see for_vectors in
+distances.h), in blocks of distance_block_size points with the blocked kernels; the blocks are spread over threads.
+*/
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "distances.h"
+#include "parallel.h"
+
+//the number of points processed by a single thread at a time
+constexpr size_t predict_grain = 16 * distance_block_size;
+
+/*
+Fuzzy c-means memberships from the distances of a single point to n_centers centers:
+	u_j = D_j^exponent / sum_l D_l^exponent
+A point lying on one or more centers is shared equally between them.
+*/
+inline void memberships_from_distances(const double* distances, size_t n_centers, double exponent, double* memberships) {
+	size_t n_zero = 0;
+	for (size_t center_idx = 0; center_idx < n_centers; ++center_idx) {
+		if (distances[center_idx] == 0.0) {
+			++n_zero;
+		}
+	}
+
+	if (n_zero > 0) {
+		for (size_t center_idx = 0; center_idx < n_centers; ++center_idx) {
+			memberships[center_idx] = distances[center_idx] == 0.0 ? 1.0 / n_zero : 0.0;
+		}
+		return;
+	}
+
+	double sum = 0.0;
+	for (size_t center_idx = 0; center_idx < n_centers; ++center_idx) {
+		memberships[center_idx] = std::pow(distances[center_idx], exponent);
+		sum += memberships[center_idx];
+	}
+	for (size_t center_idx = 0; center_idx < n_centers; ++center_idx) {
+		memberships[center_idx] /= sum;
+	}
+}
+
+/*
+Writes the memberships of vectors [first, last) of the vectors the metric was built for into memberships, vector by
+vector ((last - first) by n_clusters). fuzzifier is the m of fuzzy c-means; for a squared metric the exponent is
+-1 / (m - 1), otherwise the distances are squared first, so the default Euclidean metric gives the usual fuzzy c-means
+memberships.
+*/
+template <typename Metric, size_t n_dim, typename Scalar>
+void compute_memberships(const Metric& metric, const std::vector<std::array<Scalar, n_dim>>& vectors, size_t first, size_t last, const std::vector<double>& centers, size_t n_clusters, double fuzzifier, double* memberships) {
+	const PreparedCenters prepared_centers = metric.template prepare_centers<n_dim>(centers.data(), n_clusters);
+	const double exponent = -(Metric::is_squared ? 1.0 : 2.0) / (fuzzifier - 1.0);
+
+	parallel_for(last - first, predict_grain, [&](size_t begin, size_t end) {
+		std::vector<double> distances(distance_block_size * n_clusters);
+		for (size_t block_begin = first + begin; block_begin < first + end; block_begin += distance_block_size) {
+			size_t block_vectors = std::min(distance_block_size, first + end - block_begin);
+			metric.distance_block(block_begin, vectors.data() + block_begin, block_vectors, prepared_centers, distances.data());
+
+			for (size_t vector_idx = 0; vector_idx < block_vectors; ++vector_idx) {
+				memberships_from_distances(distances.data() + vector_idx * n_clusters, n_clusters, exponent, memberships + (block_begin - first + vector_idx) * n_clusters);
+			}
+		}
+	});
+}
+
+//writes the memberships of the points into memberships, point by point (n_points by n_clusters)
+template <typename ProblemType, size_t n_dim, typename Scalar>
+void assign_memberships(const ProblemType& solution, const std::vector<std::array<Scalar, n_dim>>& points, double fuzzifier, double* memberships) {
+	const std::vector<double>& centers = solution.get_centers();
+	compute_memberships(solution.get_metric().for_vectors(points), points, 0, points.size(), centers, solution.get_n_clusters(), fuzzifier, memberships);
+}
+
+//writes the index of the nearest center of every point into labels
+template <typename ProblemType, size_t n_dim, typename Scalar>
+void assign_labels(const ProblemType& solution, const std::vector<std::array<Scalar, n_dim>>& points, int64_t* labels) {
+	using Metric = typename ProblemType::metric_type;
+
+	const size_t n_clusters = solution.get_n_clusters();
+	const std::vector<double>& centers = solution.get_centers();
+	const Metric metric = solution.get_metric().for_vectors(points);
+	const PreparedCenters prepared_centers = metric.template prepare_centers<n_dim>(centers.data(), n_clusters);
+
+	parallel_for(points.size(), predict_grain, [&](size_t begin, size_t end) {
+		std::vector<double> distances(distance_block_size * n_clusters);
+		for (size_t block_begin = begin; block_begin < end; block_begin += distance_block_size) {
+			size_t block_points = std::min(distance_block_size, end - block_begin);
+			metric.distance_block(block_begin, points.data() + block_begin, block_points, prepared_centers, distances.data());
+
+			for (size_t point_idx = 0; point_idx < block_points; ++point_idx) {
+				const double* point_distances = distances.data() + point_idx * n_clusters;
+				labels[block_begin + point_idx] = std::min_element(point_distances, point_distances + n_clusters) - point_distances;
+			}
+		}
+	});
+}
@@ -2,6 +2,8 @@
 
 #include <numeric>
 #include <algorithm>
+#include <functional>
+#include <vector>
 
 size_t FuzzyClusteringGene::size() const noexcept {
 	return weights.size();
@@ -136,3 +138,30 @@ void FuzzyClusteringGene::repair() {
 	double sum = std::accumulate(weights.begin(), weights.end(), 0.0);
 	std::transform(weights.begin(), weights.end(), weights.begin(), [sum](const double weight) { return weight / sum; });
 }
+
+
+void SparseFuzzyClusteringGene::repair() {
+	std::transform(begin(), end(), begin(), [](const double weight) { return std::clamp(weight, 0.0, 1.0); });
+
+	if (n_memberships < size()) {
+		std::vector<double> sorted(cbegin(), cend());
+		std::nth_element(sorted.begin(), sorted.begin() + n_memberships - 1, sorted.end(), std::greater<double>());
+		double threshold = sorted[n_memberships - 1];
+
+		//ties at the threshold are broken by position so that exactly n_memberships weights survive
+		size_t kept = 0;
+		for (double& weight : *this) {
+			if (weight > threshold) {
+				++kept;
+			}
+		}
+		for (double& weight : *this) {
+			if (weight < threshold || (weight == threshold && kept++ >= n_memberships)) {
+				weight = 0.0;
+			}
+		}
+	}
+
+	double sum = std::accumulate(cbegin(), cend(), 0.0);
+	std::transform(begin(), end(), begin(), [sum](const double weight) { return weight / sum; });
+}
\ No newline at end of file
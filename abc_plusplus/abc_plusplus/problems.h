@@ -9,8 +9,22 @@ core logic manipulate them
 #include <random>
 #include <tuple>
 #include <numeric>
+#include <memory>
+#include <limits>
+#include <cmath>
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
 
 #include "util.h"
+#include "distances.h"
+#include "predict.h"
+#include "initialization.h"
+#include "numa.h"
+#include "sharded.h"
 
 class FuzzyClusteringGene {
 public:
@@ -63,67 +77,242 @@ FuzzyClusteringGene operator-(double b, FuzzyClusteringGene a);
 FuzzyClusteringGene operator*(double b, FuzzyClusteringGene a);
 FuzzyClusteringGene operator/(double b, FuzzyClusteringGene a);
 
-template <size_t n_dim>
+/*
+A gene of SparseFuzzyClustering. Arithmetic is done on the dense membership vector, repair() additionally keeps only the
+n_memberships largest weights before normalizing.
+*/
+class SparseFuzzyClusteringGene : public FuzzyClusteringGene {
+public:
+	SparseFuzzyClusteringGene(size_t n_clusters, size_t n_memberships):
+		FuzzyClusteringGene(n_clusters),
+		n_memberships(n_memberships) {
+
+	}
+
+	void repair();
+
+private:
+	size_t n_memberships;
+};
+
+//a new dataset holding the vectors followed by the points, for the extend_params of the problems
+template <size_t n_dim, typename Scalar>
+std::shared_ptr<std::vector<std::array<Scalar, n_dim>>> copy_vectors(const std::vector<std::array<Scalar, n_dim>>& vectors, const std::vector<std::array<Scalar, n_dim>>& points) {
+	auto result = std::make_shared<std::vector<std::array<Scalar, n_dim>>>();
+	result->reserve(vectors.size() + points.size());
+	result->insert(result->end(), vectors.cbegin(), vectors.cend());
+	result->insert(result->end(), points.cbegin(), points.cend());
+	return result;
+}
+
+/*
+Scalar is the type in which the dataset and the membership weights are stored. With float the memory footprint of the
+colony is halved; genes, centers and all reductions are still computed in double.
+
+Metric is one of the distance metric policies from distances.h. The metric is built from the dataset by
+FuzzyClustering::prepare_params, which the colony calls once on construction, so it is shared by all bees.
+
+initialization selects how new solutions are generated (see initialization.h); uniformly random memberships when empty.
+
+With a NUMA placement other than none, prepare_params also copies the dataset to replicas (see numa.h), from which
+compute_fitness and get_centers read instead of vectors.
+
+With shards, the worker processes holding the dataset (see sharded.h) also hold the memberships of every solution,
+and compute_fitness and get_centers are delegated to them; vectors may be empty. The metric must then be given, built
+from the whole dataset (for_vectors of it with no vectors keeps the statistics without the per-vector data).
+Initialization methods and operations that need the vectors themselves (k-means++, warm starts, refinement, appending
+vectors) are not available, and neither is get_value (nor checkpoints), since the process holds no memberships.
+*/
+template <size_t n_dim, typename Scalar = double, typename Metric = EuclideanMetric>
 struct FuzzyClusteringParams {
 	size_t n_clusters;
-	std::vector<std::array<double, n_dim>>* vectors;
+	std::vector<std::array<Scalar, n_dim>>* vectors;
+	std::shared_ptr<const Metric> metric;
+	std::shared_ptr<const Initialization> initialization;
+	NumaPlacement placement = NumaPlacement::none;
+	std::shared_ptr<const DatasetReplicas<std::array<Scalar, n_dim>>> replicas;
+	std::shared_ptr<const ShardedEvaluator<n_dim, Scalar, Metric>> shards;
+	//holds the vectors once extend_params has copied them, the dataset given by the caller is never modified
+	std::shared_ptr<std::vector<std::array<Scalar, n_dim>>> owned_vectors;
 };
 
-template <size_t n_dim>
+//the fitness is the reciprocal of sum_ij u_ij D(x_i, c_j), where the centers c_j are the membership-weighted means
+template <size_t n_dim, typename Scalar = double, typename Metric = EuclideanMetric>
 class FuzzyClustering {
 public:
 	using gene_type = FuzzyClusteringGene;
 	using fitness_type = double;
-	using params_type = FuzzyClusteringParams<n_dim>;
+	using params_type = FuzzyClusteringParams<n_dim, Scalar, Metric>;
+	using scalar_type = Scalar;
+	using metric_type = Metric;
 
 	template <typename RNGType>
-	FuzzyClustering(const FuzzyClusteringParams<n_dim>& params, RNGType& rng):
-		weights(params.n_clusters * params.vectors->size()),
-		n_clusters(params.n_clusters),
+	FuzzyClustering(const params_type& params, RNGType& rng):
 		vectors(params.vectors),
-		n_vectors(params.vectors->size()) {
+		weights(params.shards ? 0 : params.n_clusters * dataset_size(params)),
+		n_clusters(params.n_clusters),
+		n_vectors(dataset_size(params)),
+		metric(params.metric ? params.metric : prepare_params(params).metric),
+		replicas(params.replicas),
+		shards(params.shards),
+		initialization(prepare_initialization(params.initialization, *params.vectors, params.n_clusters)),
+		sharded_weights(params.shards ? params.shards->create_solution() : nullptr) {
 
 		randomize_value(rng);
 	}
 
 
-	FuzzyClustering(const FuzzyClusteringParams<n_dim>& params, const std::vector<double>& weights) :
+	FuzzyClustering(const params_type& params, const std::vector<Scalar>& weights) :
+		vectors(params.vectors),
 		weights(weights),
 		n_clusters(params.n_clusters),
-		vectors(params.vectors),
-		n_vectors(params.vectors->size()) {
+		n_vectors(dataset_size(params)),
+		metric(params.metric ? params.metric : prepare_params(params).metric),
+		replicas(params.replicas),
+		shards(params.shards),
+		initialization(prepare_initialization(params.initialization, *params.vectors, params.n_clusters)),
+		sharded_weights(params.shards ? params.shards->create_solution() : nullptr) {
 
+		upload_weights();
 	}
 
-	FuzzyClustering(const FuzzyClusteringParams<n_dim>& params, std::vector<double>&& weights) :
+	FuzzyClustering(const params_type& params, std::vector<Scalar>&& weights) :
+		vectors(params.vectors),
 		weights(std::move(weights)),
 		n_clusters(params.n_clusters),
+		n_vectors(dataset_size(params)),
+		metric(params.metric ? params.metric : prepare_params(params).metric),
+		replicas(params.replicas),
+		shards(params.shards),
+		initialization(prepare_initialization(params.initialization, *params.vectors, params.n_clusters)),
+		sharded_weights(params.shards ? params.shards->create_solution() : nullptr) {
+
+		upload_weights();
+	}
+
+	//converts a solution stored with a different precision, e.g. to re-evaluate or polish a float champion in double
+	template <typename OtherScalar>
+	FuzzyClustering(const params_type& params, const FuzzyClustering<n_dim, OtherScalar, Metric>& other) :
 		vectors(params.vectors),
-		n_vectors(params.vectors->size()) {
+		weights(other.get_value().cbegin(), other.get_value().cend()),
+		n_clusters(params.n_clusters),
+		n_vectors(dataset_size(params)),
+		metric(params.metric ? params.metric : prepare_params(params).metric),
+		replicas(params.replicas),
+		shards(params.shards),
+		initialization(prepare_initialization(params.initialization, *params.vectors, params.n_clusters)),
+		sharded_weights(params.shards ? params.shards->create_solution() : nullptr) {
 
+		upload_weights();
 	}
 
-	fitness_type compute_fitness() const {
-		fitness_type result = 0;
+	//builds the metric and the replicas of the dataset unless they are already present
+	static params_type prepare_params(params_type params) {
+		if (params.shards && !params.metric) {
+			throw std::invalid_argument("a sharded dataset needs the metric of the whole dataset");
+		}
+		if (!params.metric) {
+			params.metric = std::make_shared<const Metric>(*params.vectors);
+		}
+		if (params.placement != NumaPlacement::none && !params.replicas) {
+			params.replicas = std::make_shared<const DatasetReplicas<std::array<Scalar, n_dim>>>(*params.vectors, params.placement);
+		}
+		params.initialization = prepare_initialization(params.initialization, *params.vectors, params.n_clusters);
+		return params;
+	}
+
+	/*
+	Appends the points to a copy of the dataset, owned by the returned parameters, and rebuilds the metric and the
+	replicas. The vectors the parameters pointed to stay as they were, since other colonies may share them.
+	*/
+	static params_type extend_params(params_type params, const std::vector<std::array<Scalar, n_dim>>& points) {
+		if (params.shards) {
+			throw std::logic_error("vectors cannot be appended to a sharded dataset");
+		}
+		params.owned_vectors = copy_vectors(*params.vectors, points);
+		params.vectors = params.owned_vectors.get();
+		params.metric = nullptr;
+		params.replicas = nullptr;
+		return prepare_params(params);
+	}
+
+	/*
+	Extends the solution to the vectors appended to the dataset by extend_params. The new vectors get the fuzzy c-means
+	memberships (m = 2) with respect to the current centers.
+	*/
+	void append_vectors(const params_type& params) {
+		const std::vector<double> cluster_centers = get_centers();
+		const size_t new_n_vectors = params.vectors->size();
 
+		vectors = params.vectors;
+		metric = params.metric;
+		replicas = params.replicas;
+
+		std::vector<double> new_memberships((new_n_vectors - n_vectors) * n_clusters);
+		compute_memberships(*metric, *vectors, n_vectors, new_n_vectors, cluster_centers, n_clusters, 2.0, new_memberships.data());
+
+		std::vector<Scalar> new_weights(n_clusters * new_n_vectors);
 		for (size_t cluster_idx = 0; cluster_idx < n_clusters; ++cluster_idx) {
-			std::vector<std::array<double, n_dim>> weighted_vectors(n_vectors);
-			elementwise_multiply(vectors->cbegin(), weighted_vectors.begin(), weights.cbegin() + cluster_idx * n_vectors, weights.cbegin() + (cluster_idx + 1) * n_vectors);
+			std::copy(weights.cbegin() + cluster_idx * n_vectors, weights.cbegin() + (cluster_idx + 1) * n_vectors, new_weights.begin() + cluster_idx * new_n_vectors);
+			for (size_t vector_idx = n_vectors; vector_idx < new_n_vectors; ++vector_idx) {
+				new_weights[cluster_idx * new_n_vectors + vector_idx] = static_cast<Scalar>(new_memberships[(vector_idx - n_vectors) * n_clusters + cluster_idx]);
+			}
+		}
+
+		weights = std::move(new_weights);
+		n_vectors = new_n_vectors;
+	}
 
-			std::array<double, n_dim> weighted_vector_sum = std::accumulate(weighted_vectors.cbegin() + 1, weighted_vectors.cend(), weighted_vectors[0], [](const auto& a, const auto& b) { return a + b; });
-			double cluster_weight_sum = std::accumulate(weights.cbegin() + cluster_idx * n_vectors + 1, weights.cbegin() + (cluster_idx + 1) * n_vectors, weights[cluster_idx * n_vectors]);
+	//the membership-weighted means of the vectors, cluster by cluster
+	std::vector<double> get_centers() const {
+		if (shards) {
+			flush_genes();
+			return shards->compute_centers(*sharded_weights, n_clusters);
+		}
+
+		std::vector<double> cluster_centers(n_clusters * n_dim);
+		std::vector<double> cluster_weight_sums(n_clusters);
+		accumulate_weighted_sums(get_local_vectors(), n_vectors, weights.data(), n_vectors, n_clusters, cluster_centers.data(), cluster_weight_sums.data());
+		divide_weighted_sums<n_dim>(cluster_centers.data(), cluster_weight_sums.data(), n_clusters);
 
-			std::array<double, n_dim> cluster_center = weighted_vector_sum / cluster_weight_sum;
+		return cluster_centers;
+	}
 
+	fitness_type compute_fitness() const {
+		if (shards) {
+			flush_genes();
+			return 1 / shards->compute_objective(*sharded_weights, n_clusters);
+		}
+
+		std::vector<double> cluster_centers = get_centers();
+		PreparedCenters prepared_centers = metric->template prepare_centers<n_dim>(cluster_centers.data(), n_clusters);
+		return 1 / weighted_distance_sum(*metric, get_local_vectors(), n_vectors, weights.data(), n_vectors, n_clusters, prepared_centers);
+	}
+
+	//the memberships, vector by vector (n_vectors by n_clusters); with shards they are collected from the workers
+	std::vector<double> get_memberships() const {
+		std::vector<Scalar> collected;
+		if (shards) {
+			flush_genes();
+			collected = shards->read_memberships(*sharded_weights, n_clusters);
+		}
+		const std::vector<Scalar>& source = shards ? collected : weights;
+
+		std::vector<double> memberships(n_vectors * n_clusters);
+		for (size_t cluster_idx = 0; cluster_idx < n_clusters; ++cluster_idx) {
 			for (size_t vector_idx = 0; vector_idx < n_vectors; ++vector_idx) {
-				result += weights[cluster_idx * n_vectors + vector_idx] * euclidean_dist((*vectors)[vector_idx].cbegin(), (*vectors)[vector_idx].cend(), cluster_center.cbegin());
+				memberships[vector_idx * n_clusters + cluster_idx] = source[cluster_idx * n_vectors + vector_idx];
 			}
 		}
 
-		return 1 / result;
+		return memberships;
 	}
 
-	gene_type get_gene(size_t index) const noexcept {
+	gene_type get_gene(size_t index) const {
+		if (shards) {
+			return get_genes({ index }).front();
+		}
+
 		gene_type result(n_clusters);
 		auto iter = result.begin();
 		for (size_t i = index; i < weights.size(); i += n_vectors) {
@@ -134,10 +323,41 @@ public:
 		return result;
 	}
 
-	void set_gene(size_t index, gene_type new_value) noexcept {
+	//the genes at the indices; with shards, one request per worker instead of one per gene (see get_genes in colonies.h)
+	std::vector<gene_type> get_genes(const std::vector<size_t>& indices) const {
+		std::vector<gene_type> result;
+		result.reserve(indices.size());
+		if (!shards) {
+			for (size_t index : indices) {
+				result.push_back(get_gene(index));
+			}
+			return result;
+		}
+
+		flush_genes();
+		std::vector<Scalar> values(indices.size() * n_clusters);
+		shards->read_genes(*sharded_weights, indices.data(), indices.size(), n_clusters, values.data());
+		for (size_t gene_idx = 0; gene_idx < indices.size(); ++gene_idx) {
+			result.emplace_back(n_clusters);
+			std::copy(values.cbegin() + gene_idx * n_clusters, values.cbegin() + (gene_idx + 1) * n_clusters, result.back().begin());
+		}
+		return result;
+	}
+
+	//with shards, the gene is sent to its worker along with the next ones, at the latest before the next request
+	void set_gene(size_t index, gene_type new_value) {
+		if (shards) {
+			pending_indices.push_back(index);
+			std::transform(new_value.cbegin(), new_value.cend(), std::back_inserter(pending_values), [](double value) { return static_cast<Scalar>(value); });
+			if (pending_indices.size() >= pending_batch) {
+				flush_genes();
+			}
+			return;
+		}
+
 		auto iter = new_value.cbegin();
 		for (size_t i = index; i < weights.size(); i += n_vectors) {
-			weights[i] = *iter;
+			weights[i] = static_cast<Scalar>(*iter);
 			++iter;
 		}
 	}
@@ -146,16 +366,41 @@ public:
 		return n_vectors;
 	}
 
-	const std::vector<double>& get_value() const {
+	const std::vector<Scalar>& get_value() const {
+		if (shards) {
+			throw std::logic_error("the memberships of a sharded solution are held by the shard workers");
+		}
 		return weights;
 	}
 
+	//the length of get_value() for the parameters; 0 with shards, where a solution built from no value is all zeros
+	static size_t value_size(const params_type& params) noexcept {
+		return params.shards ? 0 : params.n_clusters * dataset_size(params);
+	}
+
 	size_t get_n_clusters() const {
 		return n_clusters;
 	}
 
+	const Metric& get_metric() const noexcept {
+		return *metric;
+	}
+
+	//returns the fitness when the initialization computed it, see initialize_solution
+	template <typename RNGType>
+	std::optional<fitness_type> randomize_value(RNGType& rng) {
+		return initialize_solution(*this, initialization.get(), *metric, *vectors, n_clusters, rng);
+	}
+
 	template <typename RNGType>
-	void randomize_value(RNGType& rng) {
+	void randomize_uniform(RNGType& rng) {
+		//every gene is overwritten, so copies of the solution keep the previous memberships without copying them
+		if (shards) {
+			pending_indices.clear();
+			pending_values.clear();
+			sharded_weights = shards->create_solution();
+		}
+
 		std::uniform_real_distribution<double> dist(0, 1);
 		for (size_t gene_index = 0; gene_index < n_vectors; ++gene_index) {
 			FuzzyClusteringGene gene(n_clusters);
@@ -170,9 +415,754 @@ public:
 		}
 	}
 
+	//the fuzzy c-means memberships (m = 2) for the given centers
+	void assign_from_centers(const std::vector<double>& centers) {
+		if (shards) {
+			throw std::logic_error("memberships cannot be assigned from centers with a sharded dataset");
+		}
+
+		std::vector<double> memberships(n_vectors * n_clusters);
+		compute_memberships(*metric, *vectors, 0, n_vectors, centers, n_clusters, 2.0, memberships.data());
+
+		for (size_t cluster_idx = 0; cluster_idx < n_clusters; ++cluster_idx) {
+			for (size_t vector_idx = 0; vector_idx < n_vectors; ++vector_idx) {
+				weights[cluster_idx * n_vectors + vector_idx] = static_cast<Scalar>(memberships[vector_idx * n_clusters + cluster_idx]);
+			}
+		}
+	}
+
+	/*
+	Alternates the center and membership updates of fuzzy c-means (m = 2) n_iterations times, starting from the centers
+	of the solution. The result is not necessarily fitter; the colony keeps it only if it is (see Bee::refine).
+	*/
+	void refine(size_t n_iterations) {
+		for (size_t iteration = 0; iteration < n_iterations; ++iteration) {
+			assign_from_centers(get_centers());
+		}
+	}
+
+	//every membership u is replaced with 1 - u, renormalized
+	FuzzyClustering opposite() const {
+		if (shards) {
+			flush_genes();
+			FuzzyClustering result(*this);
+			result.sharded_weights = shards->opposite_solution(*sharded_weights, n_clusters);
+			return result;
+		}
+
+		FuzzyClustering result(*this);
+		if (n_clusters > 1) {
+			for (Scalar& weight : result.weights) {
+				weight = static_cast<Scalar>((1.0 - weight) / (n_clusters - 1));
+			}
+		}
+
+		return result;
+	}
+
 private:
-	std::vector<std::array<double, n_dim>>* vectors;
-	std::vector<double> weights;
+	static size_t dataset_size(const params_type& params) noexcept {
+		return params.shards ? params.shards->size() : params.vectors->size();
+	}
+
+	//the replica on the node of the calling thread when the dataset is replicated
+	const std::array<Scalar, n_dim>* get_local_vectors() const noexcept {
+		return replicas ? replicas->local() : vectors->data();
+	}
+
+	std::vector<std::array<Scalar, n_dim>>* vectors;
+	std::vector<Scalar> weights;
 	size_t n_clusters;
 	size_t n_vectors;
+	std::shared_ptr<const Metric> metric;
+	std::shared_ptr<const DatasetReplicas<std::array<Scalar, n_dim>>> replicas;
+	std::shared_ptr<const ShardedEvaluator<n_dim, Scalar, Metric>> shards;
+	std::shared_ptr<const Initialization> initialization;
+
+	/*
+	With shards, the memberships held by the workers, declared after shards so that they are released first. Copies of
+	the solution share them until one of the copies sends a changed gene, which first has the workers copy them. The
+	genes set since the last request wait in pending_indices and pending_values (n_clusters values per gene) and are
+	sent when pending_batch of them have gathered or before the memberships are read; they are mutable because the
+	const accessors send them. Solutions shared between threads (e.g. by the asynchronous colony) have been evaluated,
+	so they have no pending genes.
+	*/
+	static constexpr size_t pending_batch = 4096;
+	mutable typename ShardedEvaluator<n_dim, Scalar, Metric>::solution_handle sharded_weights;
+	mutable std::vector<size_t> pending_indices;
+	mutable std::vector<Scalar> pending_values;
+
+	void flush_genes() const {
+		if (pending_indices.empty()) {
+			return;
+		}
+		if (sharded_weights.use_count() > 1) {
+			sharded_weights = shards->copy_solution(*sharded_weights, n_clusters);
+		}
+		shards->write_genes(*sharded_weights, pending_indices.data(), pending_values.data(), pending_indices.size(), n_clusters);
+		pending_indices.clear();
+		pending_values.clear();
+	}
+
+	//with shards, moves the memberships given to the constructor to the workers
+	void upload_weights() {
+		if (!shards || weights.empty()) {
+			return;
+		}
+		if (weights.size() != n_clusters * n_vectors) {
+			throw std::invalid_argument("the memberships do not match the dataset");
+		}
+
+		const std::vector<Scalar> uploaded = std::move(weights);
+		weights.clear();
+		for (size_t vector_idx = 0; vector_idx < n_vectors; ++vector_idx) {
+			gene_type gene(n_clusters);
+			for (size_t cluster_idx = 0; cluster_idx < n_clusters; ++cluster_idx) {
+				gene[cluster_idx] = uploaded[cluster_idx * n_vectors + vector_idx];
+			}
+			set_gene(vector_idx, std::move(gene));
+		}
+		flush_genes();
+	}
+};
+
+/*
+A gene of CentroidFuzzyClustering - the center of a single cluster. repair() clamps the center to the bounding box of
+the dataset, which is shared by all genes of a problem.
+*/
+template <size_t n_dim>
+class FuzzyCentroidGene {
+public:
+	using bounds_type = std::pair<std::array<double, n_dim>, std::array<double, n_dim>>;
+
+	FuzzyCentroidGene(const std::array<double, n_dim>& center, std::shared_ptr<const bounds_type> bounds):
+		center(center),
+		bounds(std::move(bounds)) {
+
+	}
+
+	void repair() {
+		for (size_t dimension = 0; dimension < n_dim; ++dimension) {
+			center[dimension] = std::clamp(center[dimension], bounds->first[dimension], bounds->second[dimension]);
+		}
+	}
+
+	const std::array<double, n_dim>& get_center() const noexcept {
+		return center;
+	}
+
+	FuzzyCentroidGene& operator+=(const FuzzyCentroidGene& other) {
+		center += other.center;
+		return *this;
+	}
+
+	FuzzyCentroidGene& operator-=(const FuzzyCentroidGene& other) {
+		center -= other.center;
+		return *this;
+	}
+
+	FuzzyCentroidGene& operator*=(double other) {
+		center *= other;
+		return *this;
+	}
+
+private:
+	std::array<double, n_dim> center;
+	std::shared_ptr<const bounds_type> bounds;
 };
+
+template <size_t n_dim>
+FuzzyCentroidGene<n_dim> operator+(FuzzyCentroidGene<n_dim> a, const FuzzyCentroidGene<n_dim>& b) {
+	a += b;
+	return a;
+}
+
+template <size_t n_dim>
+FuzzyCentroidGene<n_dim> operator-(FuzzyCentroidGene<n_dim> a, const FuzzyCentroidGene<n_dim>& b) {
+	a -= b;
+	return a;
+}
+
+template <size_t n_dim>
+FuzzyCentroidGene<n_dim> operator*(FuzzyCentroidGene<n_dim> a, double b) {
+	a *= b;
+	return a;
+}
+
+template <size_t n_dim>
+FuzzyCentroidGene<n_dim> operator*(double b, FuzzyCentroidGene<n_dim> a) {
+	a *= b;
+	return a;
+}
+
+template <size_t n_dim, typename Scalar = double, typename Metric = SquaredEuclideanMetric>
+struct CentroidFuzzyClusteringParams {
+	size_t n_clusters;
+	std::vector<std::array<Scalar, n_dim>>* vectors;
+	//the fuzzifier m of fuzzy c-means, greater than 1
+	double fuzzifier = 2.0;
+	//filled in by CentroidFuzzyClustering::prepare_params
+	std::shared_ptr<const Metric> metric;
+	//centers at random vectors when empty
+	std::shared_ptr<const Initialization> initialization;
+	//holds the vectors once extend_params has copied them
+	std::shared_ptr<std::vector<std::array<Scalar, n_dim>>> owned_vectors;
+};
+
+/*
+Fuzzy clustering encoded by the k cluster centers instead of the membership matrix, so the size of a solution does not
+depend on the number of vectors. The memberships are derived from the centers in closed form, as in fuzzy c-means:
+	u_ij = 1 / sum_l (d_ij / d_il)^(2 / (m - 1))
+and the fitness is the reciprocal of the fuzzy c-means objective sum_ij u_ij^m d_ij^2, which for these memberships
+reduces to sum_i (sum_j d_ij^(-2 / (m - 1)))^(1 - m).
+Metric gives d_ij^2; the default squared Euclidean metric makes this the classic fuzzy c-means objective.
+*/
+template <size_t n_dim, typename Scalar = double, typename Metric = SquaredEuclideanMetric>
+class CentroidFuzzyClustering {
+public:
+	using gene_type = FuzzyCentroidGene<n_dim>;
+	using fitness_type = double;
+	using params_type = CentroidFuzzyClusteringParams<n_dim, Scalar, Metric>;
+	using scalar_type = Scalar;
+	using metric_type = Metric;
+
+	template <typename RNGType>
+	CentroidFuzzyClustering(const params_type& params, RNGType& rng):
+		vectors(params.vectors),
+		centers(params.n_clusters * n_dim),
+		n_clusters(params.n_clusters),
+		fuzzifier(params.fuzzifier),
+		bounds(compute_bounds(*params.vectors)),
+		metric(params.metric ? params.metric : prepare_params(params).metric),
+		initialization(prepare_initialization(params.initialization, *params.vectors, params.n_clusters)) {
+
+		randomize_value(rng);
+	}
+
+	CentroidFuzzyClustering(const params_type& params, std::vector<double>&& centers):
+		vectors(params.vectors),
+		centers(std::move(centers)),
+		n_clusters(params.n_clusters),
+		fuzzifier(params.fuzzifier),
+		bounds(compute_bounds(*params.vectors)),
+		metric(params.metric ? params.metric : prepare_params(params).metric),
+		initialization(prepare_initialization(params.initialization, *params.vectors, params.n_clusters)) {
+
+	}
+
+	static params_type prepare_params(params_type params) {
+		//the random centers are distinct vectors of the dataset
+		if (params.n_clusters == 0 || params.n_clusters > params.vectors->size()) {
+			throw std::invalid_argument("the number of clusters must be between 1 and the number of vectors");
+		}
+		if (!params.metric) {
+			params.metric = std::make_shared<const Metric>(*params.vectors);
+		}
+		params.initialization = prepare_initialization(params.initialization, *params.vectors, params.n_clusters);
+		return params;
+	}
+
+	static params_type extend_params(params_type params, const std::vector<std::array<Scalar, n_dim>>& points) {
+		params.owned_vectors = copy_vectors(*params.vectors, points);
+		params.vectors = params.owned_vectors.get();
+		params.metric = nullptr;
+		return prepare_params(params);
+	}
+
+	//the centers do not depend on the vectors, only the bounds and the metric are updated
+	void append_vectors(const params_type& params) {
+		vectors = params.vectors;
+		metric = params.metric;
+		bounds = compute_bounds(*vectors);
+	}
+
+	fitness_type compute_fitness() const {
+		const double exponent = -1.0 / (fuzzifier - 1.0);
+		const size_t n_vectors = vectors->size();
+
+		PreparedCenters prepared_centers = metric->template prepare_centers<n_dim>(centers.data(), n_clusters);
+
+		double result = 0.0;
+		std::vector<double> distances(distance_block_size * n_clusters);
+		for (size_t block_begin = 0; block_begin < n_vectors; block_begin += distance_block_size) {
+			size_t block_vectors = std::min(distance_block_size, n_vectors - block_begin);
+			metric->distance_block(block_begin, vectors->data() + block_begin, block_vectors, prepared_centers, distances.data());
+
+			for (size_t vector_idx = 0; vector_idx < block_vectors; ++vector_idx) {
+				double inverse_sum = 0.0;
+				bool on_center = false;
+				for (size_t cluster_idx = 0; cluster_idx < n_clusters; ++cluster_idx) {
+					double squared_dist = distances[vector_idx * n_clusters + cluster_idx];
+					if (squared_dist == 0.0) {
+						on_center = true;
+						break;
+					}
+					inverse_sum += std::pow(squared_dist, exponent);
+				}
+
+				//a vector lying on a center has membership 1 in its cluster and contributes nothing
+				if (!on_center) {
+					result += std::pow(inverse_sum, 1.0 - fuzzifier);
+				}
+			}
+		}
+
+		return 1 / result;
+	}
+
+	gene_type get_gene(size_t index) const {
+		std::array<double, n_dim> center{};
+		std::copy(centers.cbegin() + index * n_dim, centers.cbegin() + (index + 1) * n_dim, center.begin());
+		return gene_type(center, bounds);
+	}
+
+	void set_gene(size_t index, const gene_type& new_value) noexcept {
+		std::copy(new_value.get_center().cbegin(), new_value.get_center().cend(), centers.begin() + index * n_dim);
+	}
+
+	size_t gene_count() const noexcept {
+		return n_clusters;
+	}
+
+	//the centers, cluster by cluster
+	const std::vector<double>& get_value() const {
+		return centers;
+	}
+
+	static size_t value_size(const params_type& params) noexcept {
+		return params.n_clusters * n_dim;
+	}
+
+	const std::vector<double>& get_centers() const {
+		return centers;
+	}
+
+	//the fuzzy c-means memberships of the centers, vector by vector (n_vectors by n_clusters)
+	std::vector<double> get_memberships() const {
+		std::vector<double> memberships(vectors->size() * n_clusters);
+		compute_memberships(*metric, *vectors, 0, vectors->size(), centers, n_clusters, fuzzifier, memberships.data());
+		return memberships;
+	}
+
+	size_t get_n_clusters() const {
+		return n_clusters;
+	}
+
+	const Metric& get_metric() const noexcept {
+		return *metric;
+	}
+
+	template <typename RNGType>
+	std::optional<fitness_type> randomize_value(RNGType& rng) {
+		return initialize_solution(*this, initialization.get(), *metric, *vectors, n_clusters, rng);
+	}
+
+	//the centers, clamped to the bounds of the dataset
+	void assign_from_centers(const std::vector<double>& new_centers) {
+		for (size_t value_idx = 0; value_idx < centers.size(); ++value_idx) {
+			size_t dimension = value_idx % n_dim;
+			centers[value_idx] = std::clamp(new_centers[value_idx], bounds->first[dimension], bounds->second[dimension]);
+		}
+	}
+
+	/*
+	n_iterations of fuzzy c-means with the fuzzifier of the problem: the memberships of the current centers, then the
+	means of the vectors weighted by u^m. Every iteration decreases the objective (for the squared Euclidean metric).
+	A cluster without weight keeps its center.
+	*/
+	void refine(size_t n_iterations) {
+		const size_t n_vectors = vectors->size();
+		std::vector<double> memberships(n_vectors * n_clusters);
+		std::vector<double> new_centers(n_clusters * n_dim);
+		std::vector<double> cluster_weight_sums(n_clusters);
+
+		for (size_t iteration = 0; iteration < n_iterations; ++iteration) {
+			compute_memberships(*metric, *vectors, 0, n_vectors, centers, n_clusters, fuzzifier, memberships.data());
+
+			std::fill(new_centers.begin(), new_centers.end(), 0.0);
+			std::fill(cluster_weight_sums.begin(), cluster_weight_sums.end(), 0.0);
+			for (size_t vector_idx = 0; vector_idx < n_vectors; ++vector_idx) {
+				const std::array<Scalar, n_dim>& vector = (*vectors)[vector_idx];
+				for (size_t cluster_idx = 0; cluster_idx < n_clusters; ++cluster_idx) {
+					double weight = std::pow(memberships[vector_idx * n_clusters + cluster_idx], fuzzifier);
+					double* weighted_vector_sum = new_centers.data() + cluster_idx * n_dim;
+					for (size_t dimension = 0; dimension < n_dim; ++dimension) {
+						weighted_vector_sum[dimension] += weight * vector[dimension];
+					}
+					cluster_weight_sums[cluster_idx] += weight;
+				}
+			}
+
+			for (size_t cluster_idx = 0; cluster_idx < n_clusters; ++cluster_idx) {
+				for (size_t dimension = 0; dimension < n_dim; ++dimension) {
+					size_t value_idx = cluster_idx * n_dim + dimension;
+					new_centers[value_idx] = cluster_weight_sums[cluster_idx] > 0.0 ? new_centers[value_idx] / cluster_weight_sums[cluster_idx] : centers[value_idx];
+				}
+			}
+			assign_from_centers(new_centers);
+		}
+	}
+
+	//every center is reflected through the middle of the bounding box of the dataset
+	CentroidFuzzyClustering opposite() const {
+		CentroidFuzzyClustering result(*this);
+		for (size_t value_idx = 0; value_idx < centers.size(); ++value_idx) {
+			size_t dimension = value_idx % n_dim;
+			result.centers[value_idx] = bounds->first[dimension] + bounds->second[dimension] - centers[value_idx];
+		}
+
+		return result;
+	}
+
+	//starts from k distinct vectors of the dataset
+	template <typename RNGType>
+	void randomize_uniform(RNGType& rng) {
+		std::vector<size_t> chosen = uniform_ints(0, vectors->size() - 1, n_clusters, rng);
+		for (size_t cluster_idx = 0; cluster_idx < n_clusters; ++cluster_idx) {
+			std::copy((*vectors)[chosen[cluster_idx]].cbegin(), (*vectors)[chosen[cluster_idx]].cend(), centers.begin() + cluster_idx * n_dim);
+		}
+	}
+
+private:
+	std::vector<std::array<Scalar, n_dim>>* vectors;
+	std::vector<double> centers;
+	size_t n_clusters;
+	double fuzzifier;
+	std::shared_ptr<const typename gene_type::bounds_type> bounds;
+	std::shared_ptr<const Metric> metric;
+	std::shared_ptr<const Initialization> initialization;
+
+	static std::shared_ptr<const typename gene_type::bounds_type> compute_bounds(const std::vector<std::array<Scalar, n_dim>>& vectors) {
+		typename gene_type::bounds_type result;
+		result.first.fill(std::numeric_limits<double>::infinity());
+		result.second.fill(-std::numeric_limits<double>::infinity());
+		for (const std::array<Scalar, n_dim>& vector : vectors) {
+			for (size_t dimension = 0; dimension < n_dim; ++dimension) {
+				result.first[dimension] = std::min<double>(result.first[dimension], vector[dimension]);
+				result.second[dimension] = std::max<double>(result.second[dimension], vector[dimension]);
+			}
+		}
+
+		return std::make_shared<const typename gene_type::bounds_type>(result);
+	}
+};
+
+
+template <size_t n_dim, typename Scalar = double, typename Metric = EuclideanMetric>
+struct SparseFuzzyClusteringParams {
+	size_t n_clusters;
+	std::vector<std::array<Scalar, n_dim>>* vectors;
+	//the number of clusters every vector may belong to
+	size_t n_memberships;
+	//filled in by SparseFuzzyClustering::prepare_params
+	std::shared_ptr<const Metric> metric;
+	//uniformly random memberships when empty
+	std::shared_ptr<const Initialization> initialization;
+	//holds the vectors once extend_params has copied them
+	std::shared_ptr<std::vector<std::array<Scalar, n_dim>>> owned_vectors;
+};
+
+//a nonzero membership of a vector
+template <typename Scalar>
+struct SparseMembership {
+	uint32_t cluster;
+	Scalar weight;
+};
+
+/*
+Fuzzy clustering with at most n_memberships nonzero memberships per vector, stored as (cluster, weight) pairs. Centers
+and distance sums cost O(n * n_memberships * n_dim) instead of O(n * n_clusters * n_dim). The fitness is the same as
+that of FuzzyClustering for the equivalent dense membership matrix.
+*/
+template <size_t n_dim, typename Scalar = double, typename Metric = EuclideanMetric>
+class SparseFuzzyClustering {
+public:
+	using gene_type = SparseFuzzyClusteringGene;
+	using fitness_type = double;
+	using params_type = SparseFuzzyClusteringParams<n_dim, Scalar, Metric>;
+	using scalar_type = Scalar;
+	using metric_type = Metric;
+
+	template <typename RNGType>
+	SparseFuzzyClustering(const params_type& params, RNGType& rng):
+		vectors(params.vectors),
+		memberships(params.vectors->size() * params.n_memberships),
+		n_clusters(params.n_clusters),
+		n_memberships(params.n_memberships),
+		n_vectors(params.vectors->size()),
+		metric(params.metric ? params.metric : prepare_params(params).metric),
+		initialization(prepare_initialization(params.initialization, *params.vectors, params.n_clusters)) {
+
+		randomize_value(rng);
+	}
+
+	//only a few distances per vector are needed, so the distances are computed one by one instead of in blocks
+	static params_type prepare_params(params_type params) {
+		if (params.n_memberships == 0 || params.n_memberships > params.n_clusters) {
+			throw std::invalid_argument("the number of memberships per vector must be between 1 and the number of clusters");
+		}
+		if (!params.metric) {
+			params.metric = std::make_shared<const Metric>(*params.vectors);
+		}
+		params.initialization = prepare_initialization(params.initialization, *params.vectors, params.n_clusters);
+		return params;
+	}
+
+	static params_type extend_params(params_type params, const std::vector<std::array<Scalar, n_dim>>& points) {
+		params.owned_vectors = copy_vectors(*params.vectors, points);
+		params.vectors = params.owned_vectors.get();
+		params.metric = nullptr;
+		return prepare_params(params);
+	}
+
+	//the new vectors get the n_memberships largest fuzzy c-means memberships (m = 2) for the current centers
+	void append_vectors(const params_type& params) {
+		const std::vector<double> cluster_centers = get_centers();
+		const size_t new_n_vectors = params.vectors->size();
+
+		vectors = params.vectors;
+		metric = params.metric;
+
+		std::vector<double> new_memberships((new_n_vectors - n_vectors) * n_clusters);
+		compute_memberships(*metric, *vectors, n_vectors, new_n_vectors, cluster_centers, n_clusters, 2.0, new_memberships.data());
+
+		memberships.resize(new_n_vectors * n_memberships);
+		for (size_t vector_idx = n_vectors; vector_idx < new_n_vectors; ++vector_idx) {
+			FuzzyClusteringGene gene(n_clusters);
+			std::copy(new_memberships.cbegin() + (vector_idx - n_vectors) * n_clusters, new_memberships.cbegin() + (vector_idx - n_vectors + 1) * n_clusters, gene.begin());
+			set_gene(vector_idx, gene);
+		}
+		n_vectors = new_n_vectors;
+	}
+
+	SparseFuzzyClustering(const params_type& params, std::vector<SparseMembership<Scalar>>&& memberships):
+		vectors(params.vectors),
+		memberships(std::move(memberships)),
+		n_clusters(params.n_clusters),
+		n_memberships(params.n_memberships),
+		n_vectors(params.vectors->size()),
+		metric(params.metric ? params.metric : prepare_params(params).metric),
+		initialization(prepare_initialization(params.initialization, *params.vectors, params.n_clusters)) {
+
+	}
+
+	//the membership-weighted means of the vectors, cluster by cluster
+	std::vector<double> get_centers() const {
+		std::vector<double> cluster_centers(n_clusters * n_dim);
+		std::vector<double> cluster_weight_sums(n_clusters);
+
+		for (size_t vector_idx = 0; vector_idx < n_vectors; ++vector_idx) {
+			const std::array<Scalar, n_dim>& vector = (*vectors)[vector_idx];
+			for (const SparseMembership<Scalar>& membership : vector_memberships(vector_idx)) {
+				double weight = membership.weight;
+				double* weighted_vector_sum = cluster_centers.data() + membership.cluster * n_dim;
+				for (size_t dimension = 0; dimension < n_dim; ++dimension) {
+					weighted_vector_sum[dimension] += weight * vector[dimension];
+				}
+				cluster_weight_sums[membership.cluster] += weight;
+			}
+		}
+
+		std::vector<size_t> empty_clusters;
+		for (size_t cluster_idx = 0; cluster_idx < n_clusters; ++cluster_idx) {
+			if (cluster_weight_sums[cluster_idx] > 0.0) {
+				for (size_t dimension = 0; dimension < n_dim; ++dimension) {
+					cluster_centers[cluster_idx * n_dim + dimension] /= cluster_weight_sums[cluster_idx];
+				}
+			}
+			else {
+				empty_clusters.push_back(cluster_idx);
+			}
+		}
+		if (!empty_clusters.empty()) {
+			reseed_clusters(cluster_centers, empty_clusters);
+		}
+
+		return cluster_centers;
+	}
+
+	fitness_type compute_fitness() const {
+		std::vector<double> cluster_centers = get_centers();
+		PreparedCenters prepared_centers = metric->template prepare_centers<n_dim>(cluster_centers.data(), n_clusters);
+
+		fitness_type result = 0;
+		for (size_t vector_idx = 0; vector_idx < n_vectors; ++vector_idx) {
+			const std::array<Scalar, n_dim>& vector = (*vectors)[vector_idx];
+			for (const SparseMembership<Scalar>& membership : vector_memberships(vector_idx)) {
+				if (membership.weight != 0) {
+					result += membership.weight * metric->distance(vector_idx, vector, prepared_centers, membership.cluster);
+				}
+			}
+		}
+
+		return 1 / result;
+	}
+
+	//the dense memberships, vector by vector (n_vectors by n_clusters)
+	std::vector<double> get_memberships() const {
+		std::vector<double> result(n_vectors * n_clusters);
+		for (size_t vector_idx = 0; vector_idx < n_vectors; ++vector_idx) {
+			for (const SparseMembership<Scalar>& membership : vector_memberships(vector_idx)) {
+				result[vector_idx * n_clusters + membership.cluster] += membership.weight;
+			}
+		}
+
+		return result;
+	}
+
+	gene_type get_gene(size_t index) const {
+		gene_type result(n_clusters, n_memberships);
+		for (const SparseMembership<Scalar>& membership : vector_memberships(index)) {
+			result[membership.cluster] += membership.weight;
+		}
+
+		return result;
+	}
+
+	//keeps the n_memberships largest weights of the gene, renormalized
+	void set_gene(size_t index, const FuzzyClusteringGene& new_value) {
+		std::vector<uint32_t> order(n_clusters);
+		std::iota(order.begin(), order.end(), 0);
+		std::partial_sort(order.begin(), order.begin() + n_memberships, order.end(), [&new_value](uint32_t a, uint32_t b) { return new_value[a] > new_value[b]; });
+
+		double sum = 0.0;
+		for (size_t i = 0; i < n_memberships; ++i) {
+			sum += new_value[order[i]];
+		}
+
+		SparseMembership<Scalar>* target = memberships.data() + index * n_memberships;
+		for (size_t i = 0; i < n_memberships; ++i) {
+			target[i].cluster = order[i];
+			target[i].weight = static_cast<Scalar>(sum > 0.0 ? new_value[order[i]] / sum : 1.0 / n_memberships);
+		}
+	}
+
+	size_t gene_count() const noexcept {
+		return n_vectors;
+	}
+
+	//n_memberships entries per vector, vector by vector
+	const std::vector<SparseMembership<Scalar>>& get_value() const {
+		return memberships;
+	}
+
+	static size_t value_size(const params_type& params) noexcept {
+		return params.vectors->size() * params.n_memberships;
+	}
+
+	size_t get_n_clusters() const {
+		return n_clusters;
+	}
+
+	const Metric& get_metric() const noexcept {
+		return *metric;
+	}
+
+	template <typename RNGType>
+	std::optional<fitness_type> randomize_value(RNGType& rng) {
+		return initialize_solution(*this, initialization.get(), *metric, *vectors, n_clusters, rng);
+	}
+
+	template <typename RNGType>
+	void randomize_uniform(RNGType& rng) {
+		std::uniform_real_distribution<double> dist(0, 1);
+		for (size_t gene_index = 0; gene_index < n_vectors; ++gene_index) {
+			FuzzyClusteringGene gene(n_clusters);
+			for (double& value : gene) {
+				value = dist(rng);
+			}
+
+			set_gene(gene_index, gene);
+		}
+	}
+
+	//the n_memberships largest fuzzy c-means memberships (m = 2) for the given centers
+	void assign_from_centers(const std::vector<double>& centers) {
+		std::vector<double> dense_memberships(n_vectors * n_clusters);
+		compute_memberships(*metric, *vectors, 0, n_vectors, centers, n_clusters, 2.0, dense_memberships.data());
+
+		for (size_t vector_idx = 0; vector_idx < n_vectors; ++vector_idx) {
+			FuzzyClusteringGene gene(n_clusters);
+			std::copy(dense_memberships.cbegin() + vector_idx * n_clusters, dense_memberships.cbegin() + (vector_idx + 1) * n_clusters, gene.begin());
+			set_gene(vector_idx, gene);
+		}
+	}
+
+	//fuzzy c-means iterations restricted to the n_memberships largest memberships, see FuzzyClustering::refine
+	void refine(size_t n_iterations) {
+		for (size_t iteration = 0; iteration < n_iterations; ++iteration) {
+			assign_from_centers(get_centers());
+		}
+	}
+
+	//every dense membership u is replaced with 1 - u, of which the n_memberships largest are kept
+	SparseFuzzyClustering opposite() const {
+		SparseFuzzyClustering result(*this);
+		for (size_t vector_idx = 0; vector_idx < n_vectors; ++vector_idx) {
+			FuzzyClusteringGene gene = get_gene(vector_idx);
+			for (double& value : gene) {
+				value = 1.0 - value;
+			}
+			result.set_gene(vector_idx, gene);
+		}
+
+		return result;
+	}
+
+private:
+	std::vector<std::array<Scalar, n_dim>>* vectors;
+	std::vector<SparseMembership<Scalar>> memberships;
+	size_t n_clusters;
+	size_t n_memberships;
+	size_t n_vectors;
+	std::shared_ptr<const Metric> metric;
+	std::shared_ptr<const Initialization> initialization;
+
+	struct MembershipRange {
+		const SparseMembership<Scalar>* first;
+		const SparseMembership<Scalar>* last;
+
+		const SparseMembership<Scalar>* begin() const {
+			return first;
+		}
+
+		const SparseMembership<Scalar>* end() const {
+			return last;
+		}
+	};
+
+	/*
+	A cluster that is no vector's membership has no weighted mean. Its center is placed at the vector contributing most
+	to the objective (as in k-means), each empty cluster at a different one, so refine and the predictions stay defined.
+	The fitness is unaffected, since no membership refers to the cluster.
+	*/
+	void reseed_clusters(std::vector<double>& cluster_centers, const std::vector<size_t>& empty_clusters) const {
+		PreparedCenters prepared_centers = metric->template prepare_centers<n_dim>(cluster_centers.data(), n_clusters);
+		std::vector<std::pair<double, size_t>> contributions(n_vectors);
+		for (size_t vector_idx = 0; vector_idx < n_vectors; ++vector_idx) {
+			const std::array<Scalar, n_dim>& vector = (*vectors)[vector_idx];
+			double contribution = 0.0;
+			for (const SparseMembership<Scalar>& membership : vector_memberships(vector_idx)) {
+				if (membership.weight != 0) {
+					contribution += membership.weight * metric->distance(vector_idx, vector, prepared_centers, membership.cluster);
+				}
+			}
+			contributions[vector_idx] = { contribution, vector_idx };
+		}
+
+		const size_t n_seeds = std::min(empty_clusters.size(), n_vectors);
+		if (n_seeds == 0) {
+			return;
+		}
+		std::partial_sort(contributions.begin(), contributions.begin() + n_seeds, contributions.end(), std::greater<std::pair<double, size_t>>());
+		for (size_t seed_idx = 0; seed_idx < empty_clusters.size(); ++seed_idx) {
+			const std::array<Scalar, n_dim>& vector = (*vectors)[contributions[seed_idx % n_seeds].second];
+			std::copy(vector.cbegin(), vector.cend(), cluster_centers.begin() + empty_clusters[seed_idx] * n_dim);
+		}
+	}
+
+	MembershipRange vector_memberships(size_t vector_idx) const {
+		const SparseMembership<Scalar>* first = memberships.data() + vector_idx * n_memberships;
+		return MembershipRange{ first, first + n_memberships };
+	}
+};
\ No newline at end of file
@@ -0,0 +1,145 @@
+/*
+Independent restarts: ParallelRestarts runs colonies with distinct seeds concurrently over the same dataset and metric,
+and keeps the best champion.
+
+The colonies run in chunks of check_period cycles. After every chunk a restart records the fitness of its champion for
+that number of cycles, and is cancelled when the fitness is below dominance times the best fitness any restart reached
+after the same number of cycles; the thread then moves on to the next restart. Restarts are compared at equal effort
+regardless of the order in which the threads pick them up. Only the colony of the best restart so far is kept, so at
+most one colony per thread plus the best one are in memory at a time.
+*/
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include "parallel.h"
+
+struct RestartSchedule {
+	//the number of cycles between checks, 0 for a tenth of the run
+	size_t check_period = 0;
+	//the fraction of the best fitness below which a restart is cancelled, 0 to never cancel
+	double dominance = 0.95;
+};
+
+struct RestartResult {
+	uint64_t seed;
+	//the fitness of the champion when the restart finished or was cancelled
+	double fitness;
+	uint64_t evaluations;
+	size_t cycles;
+	bool cancelled;
+};
+
+/*
+	ColonyType - an ArtificialBeeColony
+*/
+template <typename ColonyType>
+class ParallelRestarts {
+public:
+	using problem_type = typename ColonyType::problem_type;
+	using params_type = typename problem_type::params_type;
+
+	/*
+	make_colony(params, seed) returns a std::unique_ptr to a colony using the given seed; it is called concurrently. The
+	params are prepared once, so the colonies share the metric. Restart i uses the seed first_seed + i.
+	*/
+	template <typename MakeColony>
+	ParallelRestarts(params_type params, size_t n_restarts, uint64_t first_seed, const MakeColony& make_colony, size_t n_threads = default_thread_count()):
+		params(problem_type::prepare_params(params)),
+		n_restarts(n_restarts),
+		first_seed(first_seed),
+		make_colony(make_colony),
+		n_threads(n_threads) {
+
+		if (n_restarts < 1) {
+			throw std::invalid_argument("at least one restart is needed");
+		}
+	}
+
+	//runs every restart for n_cycles cycles unless it is cancelled
+	void run(size_t n_cycles, RestartSchedule schedule = RestartSchedule()) {
+		const size_t check_period = schedule.check_period > 0 ? schedule.check_period : std::max<size_t>(n_cycles / 10, 1);
+		const size_t n_checks = (n_cycles + check_period - 1) / check_period;
+		best_fitness_at_check.assign(n_checks, 0.0);
+		restart_results.assign(n_restarts, RestartResult{ 0, 0.0, 0, 0, false });
+		best_colony.reset();
+		best_idx = 0;
+
+		parallel_for(n_restarts, 1, [&](size_t begin, size_t end) {
+			for (size_t restart_idx = begin; restart_idx < end; ++restart_idx) {
+				run_restart(restart_idx, n_cycles, check_period, schedule.dominance);
+			}
+		}, n_threads);
+	}
+
+	//one result per restart, in the order of the seeds
+	const std::vector<RestartResult>& results() const noexcept {
+		return restart_results;
+	}
+
+	size_t get_best_index() const noexcept {
+		return best_idx;
+	}
+
+	//the colony of the best restart; only valid after run
+	ColonyType& get_best() {
+		if (!best_colony) {
+			throw std::logic_error("the restarts have not been run");
+		}
+		return *best_colony;
+	}
+
+	std::unique_ptr<ColonyType> release_best() {
+		get_best();
+		return std::move(best_colony);
+	}
+
+private:
+	void run_restart(size_t restart_idx, size_t n_cycles, size_t check_period, double dominance) {
+		const uint64_t seed = first_seed + restart_idx;
+		std::unique_ptr<ColonyType> colony = make_colony(params, seed);
+
+		size_t cycles = 0;
+		bool cancelled = false;
+		for (size_t check_idx = 0; cycles < n_cycles; ++check_idx) {
+			size_t chunk = std::min(check_period, n_cycles - cycles);
+			colony->optimize(chunk);
+			cycles += chunk;
+
+			double fitness = colony->get_champion().get_fitness();
+			std::lock_guard<std::mutex> lock(mutex);
+			double& best_fitness = best_fitness_at_check[check_idx];
+			if (fitness < dominance * best_fitness && cycles < n_cycles) {
+				cancelled = true;
+				break;
+			}
+			best_fitness = std::max(best_fitness, fitness);
+		}
+
+		RestartResult result{ seed, colony->get_champion().get_fitness(), colony->get_evaluations(), cycles, cancelled };
+		std::lock_guard<std::mutex> lock(mutex);
+		restart_results[restart_idx] = result;
+		if (!best_colony || result.fitness > best_colony->get_champion().get_fitness()) {
+			best_colony = std::move(colony);
+			best_idx = restart_idx;
+		}
+	}
+
+	params_type params;
+	size_t n_restarts;
+	uint64_t first_seed;
+	std::function<std::unique_ptr<ColonyType>(const params_type&, uint64_t)> make_colony;
+	size_t n_threads;
+
+	std::mutex mutex;
+	std::vector<double> best_fitness_at_check;
+	std::vector<RestartResult> restart_results;
+	std::unique_ptr<ColonyType> best_colony;
+	size_t best_idx = 0;
+};
@@ -0,0 +1,133 @@
+#include "sharded.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <cstring>
+#include <csignal>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+ShardProcesses::ShardProcesses(size_t n_shards, const std::function<void(size_t, int)>& serve) {
+	for (size_t shard_idx = 0; shard_idx < n_shards; ++shard_idx) {
+		int pair[2];
+		if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0) {
+			std::string message = std::strerror(errno);
+			stop();
+			throw std::runtime_error("cannot create a socket for a shard worker: " + message);
+		}
+
+		pid_t pid = fork();
+		if (pid < 0) {
+			std::string message = std::strerror(errno);
+			close(pair[0]);
+			close(pair[1]);
+			stop();
+			throw std::runtime_error("cannot start a shard worker: " + message);
+		}
+
+		if (pid == 0) {
+			//the worker only keeps its own end, so that every worker sees the coordinator closing its socket
+			for (int socket : sockets) {
+				close(socket);
+			}
+			close(pair[0]);
+			int status = 0;
+			try {
+				serve(shard_idx, pair[1]);
+			}
+			catch (...) {
+				status = 1;
+			}
+			_exit(status);
+		}
+
+		close(pair[1]);
+		sockets.push_back(pair[0]);
+		pids.push_back(pid);
+	}
+}
+
+ShardProcesses::~ShardProcesses() {
+	stop();
+}
+
+void ShardProcesses::terminate() noexcept {
+	for (long long pid : pids) {
+		kill(static_cast<pid_t>(pid), SIGKILL);
+	}
+	stop();
+}
+
+//the workers exit once they see their socket closed
+void ShardProcesses::stop() noexcept {
+	for (int socket : sockets) {
+		close(socket);
+	}
+	for (long long pid : pids) {
+		waitpid(static_cast<pid_t>(pid), nullptr, 0);
+	}
+	sockets.clear();
+	pids.clear();
+}
+
+void send_bytes(int socket, const void* data, size_t n_bytes) {
+	const char* bytes = static_cast<const char*>(data);
+	while (n_bytes > 0) {
+		ssize_t sent = send(socket, bytes, n_bytes, MSG_NOSIGNAL);
+		if (sent < 0 && errno == EINTR) {
+			continue;
+		}
+		if (sent <= 0) {
+			throw std::runtime_error(std::string("cannot send to a shard: ") + std::strerror(errno));
+		}
+		bytes += sent;
+		n_bytes -= static_cast<size_t>(sent);
+	}
+}
+
+bool receive_bytes(int socket, void* data, size_t n_bytes) {
+	char* bytes = static_cast<char*>(data);
+	const size_t expected = n_bytes;
+	while (n_bytes > 0) {
+		ssize_t received = recv(socket, bytes, n_bytes, 0);
+		if (received < 0 && errno == EINTR) {
+			continue;
+		}
+		if (received == 0 && n_bytes == expected) {
+			return false;
+		}
+		if (received <= 0) {
+			throw std::runtime_error(received == 0 ? std::string("a shard closed the connection mid-message") : std::string("cannot receive from a shard: ") + std::strerror(errno));
+		}
+		bytes += received;
+		n_bytes -= static_cast<size_t>(received);
+	}
+	return true;
+}
+
+#else
+
+ShardProcesses::ShardProcesses(size_t, const std::function<void(size_t, int)>&) {
+	throw std::runtime_error("sharded evaluation needs a POSIX system");
+}
+
+ShardProcesses::~ShardProcesses() {
+}
+
+void ShardProcesses::terminate() noexcept {
+}
+
+void ShardProcesses::stop() noexcept {
+}
+
+void send_bytes(int, const void*, size_t) {
+	throw std::runtime_error("sharded evaluation needs a POSIX system");
+}
+
+bool receive_bytes(int, void*, size_t) {
+	throw std::runtime_error("sharded evaluation needs a POSIX system");
+}
+
+#endif
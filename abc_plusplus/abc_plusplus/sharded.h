@@ -0,0 +1,565 @@
+/*
+Sharded fitness evaluation: ShardedEvaluator splits the dataset into contiguous slices held by local worker processes,
+so that the process running the colony does not need to hold the dataset or the memberships. Every worker also holds
+the matching columns of the memberships of every solution, keyed by an id (see ShardedEvaluator::Solution). The
+coordinator sends only the genes (the memberships of single vectors) that a trial changed, reads the genes that the
+mixing needs, and has the workers copy a whole solution when a trial starts from it. The fitness of FuzzyClustering
+needs two passes over the vectors, so an evaluation takes two rounds of messages:
+	1. every worker returns the per-cluster sums of the weighted vectors and of the weights of its columns
+	2. the coordinator reduces the sums into the centers and sends them back; every worker returns the sum of the
+	   weighted distances of its vectors, which the coordinator adds up into the objective
+The workers use the same kernels as FuzzyClustering (accumulate_weighted_sums and weighted_distance_sum below), so the
+result equals compute_fitness on the whole dataset up to the order in which the partial sums are added.
+
+The workers are forked from the coordinator and talk to it over Unix domain sockets with a plain binary request and
+response protocol, which does not depend on the processes sharing memory and could be carried over TCP to other machines. The
+coordinator only reads the shape of the dataset file; every worker reads its own range of vectors from the file (see
+dataset.h) and keeps them along with the metric for them (see for_vectors in distances.h, which keeps the dataset
+statistics), so no process holds the whole dataset. POSIX only; elsewhere the constructor throws. The evaluator
+must be created before the process starts threads, see ShardProcesses.
+
+Requests to the workers are serialized, so concurrent evaluations (e.g. of the asynchronous colony) wait for each
+other; the parallelism is across the workers. A failed send or receive leaves the protocol out of step, so it stops
+the workers and every later request throws.
+*/
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "dataset.h"
+#include "distances.h"
+
+/*
+Adds sum_i u_ij x_i to weighted_sums (n_clusters by n_dim) and sum_i u_ij to weight_sums for the n_vectors vectors; the
+weights are stored cluster by cluster, the weights of cluster j starting at weights + j * weight_stride.
+*/
+template <size_t n_dim, typename Scalar>
+void accumulate_weighted_sums(const std::array<Scalar, n_dim>* vectors, size_t n_vectors, const Scalar* weights, size_t weight_stride, size_t n_clusters, double* weighted_sums, double* weight_sums) {
+	if constexpr (n_dim < distance_gemm_min_dim) {
+		//short vectors are cheap to reread, so the weights are streamed one cluster at a time
+		for (size_t cluster_idx = 0; cluster_idx < n_clusters; ++cluster_idx) {
+			const Scalar* cluster_weights = weights + cluster_idx * weight_stride;
+			double* weighted_vector_sum = weighted_sums + cluster_idx * n_dim;
+			for (size_t vector_idx = 0; vector_idx < n_vectors; ++vector_idx) {
+				for (size_t dimension = 0; dimension < n_dim; ++dimension) {
+					weighted_vector_sum[dimension] += cluster_weights[vector_idx] * vectors[vector_idx][dimension];
+				}
+				weight_sums[cluster_idx] += cluster_weights[vector_idx];
+			}
+		}
+	}
+	else {
+		//a single pass over the dataset accumulates the weighted sums of all clusters
+		for (size_t vector_idx = 0; vector_idx < n_vectors; ++vector_idx) {
+			const std::array<Scalar, n_dim>& vector = vectors[vector_idx];
+			for (size_t cluster_idx = 0; cluster_idx < n_clusters; ++cluster_idx) {
+				double weight = weights[cluster_idx * weight_stride + vector_idx];
+				double* weighted_vector_sum = weighted_sums + cluster_idx * n_dim;
+				for (size_t dimension = 0; dimension < n_dim; ++dimension) {
+					weighted_vector_sum[dimension] += weight * vector[dimension];
+				}
+				weight_sums[cluster_idx] += weight;
+			}
+		}
+	}
+}
+
+//turns the weighted sums into the membership-weighted means in place
+template <size_t n_dim>
+void divide_weighted_sums(double* weighted_sums, const double* weight_sums, size_t n_clusters) {
+	for (size_t cluster_idx = 0; cluster_idx < n_clusters; ++cluster_idx) {
+		for (size_t dimension = 0; dimension < n_dim; ++dimension) {
+			weighted_sums[cluster_idx * n_dim + dimension] /= weight_sums[cluster_idx];
+		}
+	}
+}
+
+//sum_ij u_ij D(x_i, c_j) over the n_vectors vectors, the first of which is vector 0 of the metric; weights as above
+template <size_t n_dim, typename Scalar, typename Metric>
+double weighted_distance_sum(const Metric& metric, const std::array<Scalar, n_dim>* vectors, size_t n_vectors, const Scalar* weights, size_t weight_stride, size_t n_clusters, const PreparedCenters& centers) {
+	double result = 0;
+	if constexpr (n_dim < distance_gemm_min_dim) {
+		for (size_t cluster_idx = 0; cluster_idx < n_clusters; ++cluster_idx) {
+			const Scalar* cluster_weights = weights + cluster_idx * weight_stride;
+			for (size_t vector_idx = 0; vector_idx < n_vectors; ++vector_idx) {
+				result += cluster_weights[vector_idx] * metric.distance(vector_idx, vectors[vector_idx], centers, cluster_idx);
+			}
+		}
+
+		return result;
+	}
+
+	std::vector<double> distances(distance_block_size * n_clusters);
+	for (size_t block_begin = 0; block_begin < n_vectors; block_begin += distance_block_size) {
+		size_t block_vectors = std::min(distance_block_size, n_vectors - block_begin);
+		metric.distance_block(block_begin, vectors + block_begin, block_vectors, centers, distances.data());
+
+		for (size_t cluster_idx = 0; cluster_idx < n_clusters; ++cluster_idx) {
+			const Scalar* cluster_weights = weights + cluster_idx * weight_stride + block_begin;
+			for (size_t vector_idx = 0; vector_idx < block_vectors; ++vector_idx) {
+				result += cluster_weights[vector_idx] * distances[vector_idx * n_clusters + cluster_idx];
+			}
+		}
+	}
+
+	return result;
+}
+
+/*
+Local worker processes connected to the coordinator by a Unix domain socket each. The constructor forks n_shards
+processes; process i calls serve(i, socket) and exits when it returns (or throws), which serve should do once
+receive_bytes reports that the coordinator closed the socket. The destructor closes the sockets and waits for the
+processes. The
+children of a multi-threaded process may only call async-signal-safe functions, while serve allocates and reads files,
+so the processes must be started before any other thread (e.g. of the thread pool, see parallel.h).
+*/
+class ShardProcesses {
+public:
+	ShardProcesses(size_t n_shards, const std::function<void(size_t, int)>& serve);
+	ShardProcesses(const ShardProcesses&) = delete;
+	ShardProcesses& operator=(const ShardProcesses&) = delete;
+	~ShardProcesses();
+
+	size_t size() const noexcept {
+		return sockets.size();
+	}
+
+	int get_socket(size_t shard_idx) const noexcept {
+		return sockets[shard_idx];
+	}
+
+	//kills the processes without waiting for them to finish their requests, then closes the sockets and reaps them
+	void terminate() noexcept;
+
+private:
+	void stop() noexcept;
+
+	std::vector<int> sockets;
+	std::vector<long long> pids;
+};
+
+//writes all of the bytes; throws std::runtime_error when the peer is gone
+void send_bytes(int socket, const void* data, size_t n_bytes);
+
+//reads exactly n_bytes; returns false if the peer closed the socket before the first byte, throws std::runtime_error otherwise
+bool receive_bytes(int socket, void* data, size_t n_bytes);
+
+template <size_t n_dim, typename Scalar, typename Metric>
+class ShardedEvaluator {
+public:
+	using vector_type = std::array<Scalar, n_dim>;
+
+	//the memberships of a solution held by the workers, freed when the handle is destroyed; it must not outlive the evaluator
+	class Solution {
+	public:
+		Solution(const ShardedEvaluator& evaluator, uint64_t id):
+			evaluator(evaluator),
+			id(id) {
+		}
+
+		Solution(const Solution&) = delete;
+		Solution& operator=(const Solution&) = delete;
+
+		~Solution() {
+			evaluator.release(id);
+		}
+
+		uint64_t get_id() const noexcept {
+			return id;
+		}
+
+	private:
+		const ShardedEvaluator& evaluator;
+		uint64_t id;
+	};
+
+	using solution_handle = std::shared_ptr<const Solution>;
+
+	/*
+	Splits the vectors of the dataset file (see dataset.h) into n_shards ranges of nearly equal size and starts a worker
+	for each, which reads its range from the file. metric carries the statistics of the whole dataset, if the metric
+	has any (for the others, a metric built from no vectors will do); every worker derives the metric of its vectors
+	from it.
+	*/
+	ShardedEvaluator(const std::string& path, const Metric& metric, size_t n_shards):
+		n_vectors(0),
+		next_id(0),
+		failed(false) {
+
+		const DatasetShape shape = read_dataset_shape(path, n_dim);
+		if (shape.n_dim != n_dim) {
+			throw std::invalid_argument(path + " holds " + std::to_string(shape.n_dim) + "-dimensional vectors, expected " + std::to_string(n_dim));
+		}
+		n_vectors = shape.n_vectors;
+		if (n_shards < 1 || n_shards > n_vectors) {
+			throw std::invalid_argument("the number of shards must be between 1 and the number of vectors");
+		}
+
+		for (size_t shard_idx = 0; shard_idx <= n_shards; ++shard_idx) {
+			offsets.push_back(n_vectors * shard_idx / n_shards);
+		}
+
+		processes = std::make_unique<ShardProcesses>(n_shards, [&](size_t shard_idx, int socket) {
+			std::vector<vector_type> slice(offsets[shard_idx + 1] - offsets[shard_idx]);
+			{
+				std::vector<double> values = read_dataset_vectors(path, n_dim, offsets[shard_idx], slice.size());
+				for (size_t vector_idx = 0; vector_idx < slice.size(); ++vector_idx) {
+					std::copy(values.cbegin() + vector_idx * n_dim, values.cbegin() + (vector_idx + 1) * n_dim, slice[vector_idx].begin());
+				}
+			}
+			Metric slice_metric = metric.for_vectors(slice);
+			serve(socket, slice, slice_metric);
+		});
+	}
+
+	size_t size() const noexcept {
+		return n_vectors;
+	}
+
+	size_t shard_count() const noexcept {
+		return processes->size();
+	}
+
+	//a solution whose memberships are all 0 until they are written; the workers allocate them on the first request
+	solution_handle create_solution() const {
+		uint64_t id;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			id = ++next_id;
+		}
+		return std::make_shared<const Solution>(*this, id);
+	}
+
+	//a copy of the memberships of source
+	solution_handle copy_solution(const Solution& source, size_t n_clusters) const {
+		return derive_solution(copy_request, source, n_clusters);
+	}
+
+	//the memberships of source with every u replaced by 1 - u, renormalized, see FuzzyClustering::opposite
+	solution_handle opposite_solution(const Solution& source, size_t n_clusters) const {
+		return derive_solution(opposite_request, source, n_clusters);
+	}
+
+	//sets the memberships of the vectors at indices (global, in any order) to values, n_clusters per vector
+	void write_genes(const Solution& solution, const size_t* indices, const Scalar* values, size_t count, size_t n_clusters) const {
+		std::lock_guard<std::mutex> lock(mutex);
+		guarded([&]() {
+			std::vector<std::vector<uint64_t>> local_indices(shard_count());
+			std::vector<std::vector<Scalar>> shard_values(shard_count());
+			for (size_t gene_idx = 0; gene_idx < count; ++gene_idx) {
+				const size_t shard_idx = shard_of(indices[gene_idx]);
+				local_indices[shard_idx].push_back(indices[gene_idx] - offsets[shard_idx]);
+				shard_values[shard_idx].insert(shard_values[shard_idx].end(), values + gene_idx * n_clusters, values + (gene_idx + 1) * n_clusters);
+			}
+
+			for (size_t shard_idx = 0; shard_idx < shard_count(); ++shard_idx) {
+				if (!local_indices[shard_idx].empty()) {
+					const RequestHeader header{ write_request, 0, n_clusters, solution.get_id(), local_indices[shard_idx].size() };
+					send_bytes(processes->get_socket(shard_idx), &header, sizeof(header));
+					send_bytes(processes->get_socket(shard_idx), local_indices[shard_idx].data(), local_indices[shard_idx].size() * sizeof(uint64_t));
+					send_bytes(processes->get_socket(shard_idx), shard_values[shard_idx].data(), shard_values[shard_idx].size() * sizeof(Scalar));
+				}
+			}
+		});
+	}
+
+	//reads the memberships of the vectors at indices into values, n_clusters per vector
+	void read_genes(const Solution& solution, const size_t* indices, size_t count, size_t n_clusters, Scalar* values) const {
+		std::lock_guard<std::mutex> lock(mutex);
+		guarded([&]() {
+			std::vector<std::vector<uint64_t>> local_indices(shard_count());
+			std::vector<std::vector<size_t>> positions(shard_count());
+			for (size_t gene_idx = 0; gene_idx < count; ++gene_idx) {
+				const size_t shard_idx = shard_of(indices[gene_idx]);
+				local_indices[shard_idx].push_back(indices[gene_idx] - offsets[shard_idx]);
+				positions[shard_idx].push_back(gene_idx);
+			}
+
+			for (size_t shard_idx = 0; shard_idx < shard_count(); ++shard_idx) {
+				if (!local_indices[shard_idx].empty()) {
+					const RequestHeader header{ read_request, 0, n_clusters, solution.get_id(), local_indices[shard_idx].size() };
+					send_bytes(processes->get_socket(shard_idx), &header, sizeof(header));
+					send_bytes(processes->get_socket(shard_idx), local_indices[shard_idx].data(), local_indices[shard_idx].size() * sizeof(uint64_t));
+				}
+			}
+
+			std::vector<Scalar> shard_values;
+			for (size_t shard_idx = 0; shard_idx < shard_count(); ++shard_idx) {
+				if (!local_indices[shard_idx].empty()) {
+					shard_values.resize(local_indices[shard_idx].size() * n_clusters);
+					receive_from(shard_idx, shard_values.data(), shard_values.size() * sizeof(Scalar));
+					for (size_t idx = 0; idx < positions[shard_idx].size(); ++idx) {
+						std::copy(shard_values.cbegin() + idx * n_clusters, shard_values.cbegin() + (idx + 1) * n_clusters, values + positions[shard_idx][idx] * n_clusters);
+					}
+				}
+			}
+		});
+	}
+
+	//all memberships of the solution, stored as in FuzzyClustering (n_clusters by size())
+	std::vector<Scalar> read_memberships(const Solution& solution, size_t n_clusters) const {
+		std::lock_guard<std::mutex> lock(mutex);
+		return guarded([&]() {
+			const RequestHeader header{ gather_request, 0, n_clusters, solution.get_id(), 0 };
+			for (size_t shard_idx = 0; shard_idx < shard_count(); ++shard_idx) {
+				send_bytes(processes->get_socket(shard_idx), &header, sizeof(header));
+			}
+
+			std::vector<Scalar> result(n_clusters * n_vectors);
+			std::vector<Scalar> columns;
+			for (size_t shard_idx = 0; shard_idx < shard_count(); ++shard_idx) {
+				const size_t begin = offsets[shard_idx];
+				const size_t shard_vectors = offsets[shard_idx + 1] - begin;
+				columns.resize(n_clusters * shard_vectors);
+				receive_from(shard_idx, columns.data(), columns.size() * sizeof(Scalar));
+				for (size_t cluster_idx = 0; cluster_idx < n_clusters; ++cluster_idx) {
+					std::copy(columns.cbegin() + cluster_idx * shard_vectors, columns.cbegin() + (cluster_idx + 1) * shard_vectors, result.begin() + cluster_idx * n_vectors + begin);
+				}
+			}
+			return result;
+		});
+	}
+
+	//the membership-weighted means, cluster by cluster
+	std::vector<double> compute_centers(const Solution& solution, size_t n_clusters) const {
+		std::lock_guard<std::mutex> lock(mutex);
+		return guarded([&]() { return request_centers(solution.get_id(), n_clusters); });
+	}
+
+	//sum_ij u_ij D(x_i, c_j), the reciprocal of the fitness
+	double compute_objective(const Solution& solution, size_t n_clusters) const {
+		std::lock_guard<std::mutex> lock(mutex);
+		return guarded([&]() { return request_objective(solution.get_id(), n_clusters); });
+	}
+
+	//whether an I/O error has stopped the workers
+	bool has_failed() const {
+		std::lock_guard<std::mutex> lock(mutex);
+		return failed;
+	}
+
+private:
+	//the requests that change the memberships get no response, so they only wait for the socket buffers
+	static constexpr uint32_t sums_request = 1;
+	static constexpr uint32_t distances_request = 2;
+	static constexpr uint32_t write_request = 3;
+	static constexpr uint32_t read_request = 4;
+	static constexpr uint32_t gather_request = 5;
+	static constexpr uint32_t copy_request = 6;
+	static constexpr uint32_t opposite_request = 7;
+	static constexpr uint32_t release_request = 8;
+
+	//argument - the number of indices of write and read requests, the source solution of copy and opposite requests
+	struct RequestHeader {
+		uint32_t type;
+		uint32_t reserved;
+		uint64_t n_clusters;
+		uint64_t solution;
+		uint64_t argument;
+	};
+
+	//runs a request, stopping the workers for good if it fails part way; the mutex must be held
+	template <typename Request>
+	auto guarded(const Request& request) const {
+		if (failed) {
+			throw std::runtime_error("the shard workers were stopped after an earlier error");
+		}
+		try {
+			return request();
+		}
+		catch (...) {
+			failed = true;
+			processes->terminate();
+			throw;
+		}
+	}
+
+	size_t shard_of(size_t vector_idx) const {
+		return std::upper_bound(offsets.cbegin(), offsets.cend(), vector_idx) - offsets.cbegin() - 1;
+	}
+
+	//the handle is only made once the request is sent, since releasing it takes the mutex
+	solution_handle derive_solution(uint32_t type, const Solution& source, size_t n_clusters) const {
+		uint64_t id;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			id = ++next_id;
+			guarded([&]() {
+				const RequestHeader header{ type, 0, n_clusters, id, source.get_id() };
+				for (size_t shard_idx = 0; shard_idx < shard_count(); ++shard_idx) {
+					send_bytes(processes->get_socket(shard_idx), &header, sizeof(header));
+				}
+			});
+		}
+		return std::make_shared<const Solution>(*this, id);
+	}
+
+	//called by the destructor of Solution; after an error there is nothing left to free
+	void release(uint64_t id) const noexcept {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (failed) {
+			return;
+		}
+		try {
+			guarded([&]() {
+				const RequestHeader header{ release_request, 0, 0, id, 0 };
+				for (size_t shard_idx = 0; shard_idx < shard_count(); ++shard_idx) {
+					send_bytes(processes->get_socket(shard_idx), &header, sizeof(header));
+				}
+			});
+		}
+		catch (const std::exception&) {
+		}
+	}
+
+	//both rounds of an evaluation
+	double request_objective(uint64_t solution, size_t n_clusters) const {
+		std::vector<double> centers = request_centers(solution, n_clusters);
+
+		const RequestHeader header{ distances_request, 0, n_clusters, solution, 0 };
+		for (size_t shard_idx = 0; shard_idx < shard_count(); ++shard_idx) {
+			send_bytes(processes->get_socket(shard_idx), &header, sizeof(header));
+			send_bytes(processes->get_socket(shard_idx), centers.data(), centers.size() * sizeof(double));
+		}
+
+		double objective = 0;
+		for (size_t shard_idx = 0; shard_idx < shard_count(); ++shard_idx) {
+			double shard_objective;
+			receive_from(shard_idx, &shard_objective, sizeof(shard_objective));
+			objective += shard_objective;
+		}
+		return objective;
+	}
+
+	//round 1: every worker sums its columns of the solution, the sums are reduced into the centers
+	std::vector<double> request_centers(uint64_t solution, size_t n_clusters) const {
+		const RequestHeader header{ sums_request, 0, n_clusters, solution, 0 };
+		for (size_t shard_idx = 0; shard_idx < shard_count(); ++shard_idx) {
+			send_bytes(processes->get_socket(shard_idx), &header, sizeof(header));
+		}
+
+		std::vector<double> centers(n_clusters * n_dim);
+		std::vector<double> weight_sums(n_clusters);
+		std::vector<double> shard_sums(n_clusters * (n_dim + 1));
+		for (size_t shard_idx = 0; shard_idx < shard_count(); ++shard_idx) {
+			receive_from(shard_idx, shard_sums.data(), shard_sums.size() * sizeof(double));
+			for (size_t idx = 0; idx < centers.size(); ++idx) {
+				centers[idx] += shard_sums[idx];
+			}
+			for (size_t cluster_idx = 0; cluster_idx < n_clusters; ++cluster_idx) {
+				weight_sums[cluster_idx] += shard_sums[centers.size() + cluster_idx];
+			}
+		}
+
+		divide_weighted_sums<n_dim>(centers.data(), weight_sums.data(), n_clusters);
+		return centers;
+	}
+
+	void receive_from(size_t shard_idx, void* data, size_t n_bytes) const {
+		if (!receive_bytes(processes->get_socket(shard_idx), data, n_bytes)) {
+			throw std::runtime_error("shard worker " + std::to_string(shard_idx) + " exited");
+		}
+	}
+
+	/*
+	The request loop of a worker. It holds its columns of the memberships of every live solution, stored as in
+	FuzzyClustering (n_clusters by the size of the slice) and keyed by the id of the solution; a solution that was never
+	written holds zeros.
+	*/
+	static void serve(int socket, const std::vector<vector_type>& slice, const Metric& metric) {
+		std::unordered_map<uint64_t, std::vector<Scalar>> solutions;
+		auto columns = [&solutions, &slice](uint64_t id, size_t n_clusters) -> std::vector<Scalar>& {
+			std::vector<Scalar>& result = solutions[id];
+			result.resize(n_clusters * slice.size());
+			return result;
+		};
+
+		std::vector<uint64_t> indices;
+		std::vector<Scalar> values;
+		std::vector<double> sums;
+		std::vector<double> centers;
+		RequestHeader header;
+		while (receive_bytes(socket, &header, sizeof(header))) {
+			const size_t n_clusters = static_cast<size_t>(header.n_clusters);
+			if (header.type == sums_request) {
+				const std::vector<Scalar>& weights = columns(header.solution, n_clusters);
+				sums.assign(n_clusters * (n_dim + 1), 0.0);
+				accumulate_weighted_sums(slice.data(), slice.size(), weights.data(), slice.size(), n_clusters, sums.data(), sums.data() + n_clusters * n_dim);
+				send_bytes(socket, sums.data(), sums.size() * sizeof(double));
+			}
+			else if (header.type == distances_request) {
+				centers.resize(n_clusters * n_dim);
+				receive_bytes(socket, centers.data(), centers.size() * sizeof(double));
+
+				const std::vector<Scalar>& weights = columns(header.solution, n_clusters);
+				PreparedCenters prepared_centers = metric.template prepare_centers<n_dim>(centers.data(), n_clusters);
+				double objective = weighted_distance_sum(metric, slice.data(), slice.size(), weights.data(), slice.size(), n_clusters, prepared_centers);
+				send_bytes(socket, &objective, sizeof(objective));
+			}
+			else if (header.type == write_request || header.type == read_request) {
+				indices.resize(static_cast<size_t>(header.argument));
+				receive_bytes(socket, indices.data(), indices.size() * sizeof(uint64_t));
+				for (uint64_t index : indices) {
+					if (index >= slice.size()) {
+						throw std::runtime_error("vector index outside of the shard");
+					}
+				}
+
+				std::vector<Scalar>& weights = columns(header.solution, n_clusters);
+				values.resize(indices.size() * n_clusters);
+				if (header.type == write_request) {
+					receive_bytes(socket, values.data(), values.size() * sizeof(Scalar));
+				}
+				for (size_t gene_idx = 0; gene_idx < indices.size(); ++gene_idx) {
+					for (size_t cluster_idx = 0; cluster_idx < n_clusters; ++cluster_idx) {
+						Scalar& weight = weights[cluster_idx * slice.size() + indices[gene_idx]];
+						if (header.type == write_request) {
+							weight = values[gene_idx * n_clusters + cluster_idx];
+						}
+						else {
+							values[gene_idx * n_clusters + cluster_idx] = weight;
+						}
+					}
+				}
+				if (header.type == read_request) {
+					send_bytes(socket, values.data(), values.size() * sizeof(Scalar));
+				}
+			}
+			else if (header.type == gather_request) {
+				const std::vector<Scalar>& weights = columns(header.solution, n_clusters);
+				send_bytes(socket, weights.data(), weights.size() * sizeof(Scalar));
+			}
+			else if (header.type == copy_request || header.type == opposite_request) {
+				std::vector<Scalar> weights = columns(header.argument, n_clusters);
+				if (header.type == opposite_request && n_clusters > 1) {
+					for (Scalar& weight : weights) {
+						weight = static_cast<Scalar>((1.0 - weight) / (n_clusters - 1));
+					}
+				}
+				solutions[header.solution] = std::move(weights);
+			}
+			else if (header.type == release_request) {
+				solutions.erase(header.solution);
+			}
+			else {
+				throw std::runtime_error("unknown request");
+			}
+		}
+	}
+
+	size_t n_vectors;
+	std::vector<size_t> offsets;
+	std::unique_ptr<ShardProcesses> processes;
+	mutable std::mutex mutex;
+	mutable uint64_t next_id;
+	mutable bool failed;
+};
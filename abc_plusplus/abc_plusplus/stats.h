@@ -0,0 +1,101 @@
+/*
+Per-phase performance counters for the colony.
+
+Collection is controlled by the ABC_STATS preprocessor macro. It defaults to 1 in debug builds and to 0 when NDEBUG
+is defined; with ABC_STATS set to 0 all of the recording functions below compile to nothing.
+*/
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#ifndef ABC_STATS
+#ifdef NDEBUG
+#define ABC_STATS 0
+#else
+#define ABC_STATS 1
+#endif
+#endif
+
+constexpr bool stats_enabled = ABC_STATS != 0;
+
+class Stopwatch {
+public:
+	Stopwatch() {
+		restart();
+	}
+
+	void restart() noexcept {
+		if constexpr (stats_enabled) {
+			start = std::chrono::steady_clock::now();
+		}
+	}
+
+	//adds the time since the last (re)start to the counter and restarts the stopwatch
+	void lap(uint64_t& counter) noexcept {
+		if constexpr (stats_enabled) {
+			std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+			counter += std::chrono::duration_cast<std::chrono::nanoseconds>(now - start).count();
+			start = now;
+		}
+	}
+
+private:
+	std::chrono::steady_clock::time_point start;
+};
+
+struct PhaseStats {
+	uint64_t evaluations = 0;
+	uint64_t accepted = 0;
+	uint64_t rejected = 0;
+	uint64_t mixing_ns = 0;
+	uint64_t evaluation_ns = 0;
+	uint64_t selection_ns = 0;
+
+	void record_trial(bool improved) noexcept {
+		if constexpr (stats_enabled) {
+			++evaluations;
+			if (improved) {
+				++accepted;
+			}
+			else {
+				++rejected;
+			}
+		}
+	}
+
+	void record_evaluation(uint64_t count = 1) noexcept {
+		if constexpr (stats_enabled) {
+			evaluations += count;
+		}
+	}
+};
+
+struct ColonyStats {
+	PhaseStats employed;
+	PhaseStats onlooker;
+	PhaseStats scout;
+	PhaseStats refinement;
+	uint64_t cycles = 0;
+	uint64_t champion_updates = 0;
+	//the number of scout restarts in every cycle
+	std::vector<uint64_t> abandonments;
+
+	void record_cycle(uint64_t cycle_abandonments) {
+		if constexpr (stats_enabled) {
+			++cycles;
+			abandonments.push_back(cycle_abandonments);
+		}
+	}
+
+	void record_champion_update() noexcept {
+		if constexpr (stats_enabled) {
+			++champion_updates;
+		}
+	}
+
+	uint64_t evaluations() const noexcept {
+		return employed.evaluations + onlooker.evaluations + scout.evaluations + refinement.evaluations;
+	}
+};
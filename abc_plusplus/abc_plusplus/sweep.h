@@ -0,0 +1,161 @@
+/*
+Selection of the number of clusters: KSweep runs one colony for every k in [min_clusters, max_clusters] and reports the
+fitness and the validity indices (see validity.h) of every champion.
+
+The colonies share the dataset and the metric, and run concurrently in rounds. After every round the colony for k is
+seeded with the champion of the colony for k - 1, whose widest cluster is split in two (see split_widest_cluster); the
+seed replaces the least fit bee, so it only takes over when it is better than what the colony found by itself.
+*/
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "parallel.h"
+#include "validity.h"
+
+/*
+Splits the cluster with the largest membership-weighted variance into two, returning n_clusters + 1 centers: the center
+is moved by one standard deviation both ways along the dimension in which the cluster is the widest. The memberships
+are given point by point (n by n_clusters).
+*/
+template <size_t n_dim, typename Scalar>
+std::vector<double> split_widest_cluster(const std::vector<std::array<Scalar, n_dim>>& vectors, const std::vector<double>& centers, size_t n_clusters, const double* memberships) {
+	std::vector<double> variances(n_clusters * n_dim);
+	std::vector<double> cluster_weight_sums(n_clusters);
+	for (size_t vector_idx = 0; vector_idx < vectors.size(); ++vector_idx) {
+		for (size_t cluster_idx = 0; cluster_idx < n_clusters; ++cluster_idx) {
+			double weight = memberships[vector_idx * n_clusters + cluster_idx];
+			for (size_t dimension = 0; dimension < n_dim; ++dimension) {
+				double diff = vectors[vector_idx][dimension] - centers[cluster_idx * n_dim + dimension];
+				variances[cluster_idx * n_dim + dimension] += weight * diff * diff;
+			}
+			cluster_weight_sums[cluster_idx] += weight;
+		}
+	}
+
+	size_t widest_cluster = 0;
+	double widest_variance = -1.0;
+	for (size_t cluster_idx = 0; cluster_idx < n_clusters; ++cluster_idx) {
+		double variance = 0.0;
+		for (size_t dimension = 0; dimension < n_dim; ++dimension) {
+			variances[cluster_idx * n_dim + dimension] /= std::max(cluster_weight_sums[cluster_idx], 1e-300);
+			variance += variances[cluster_idx * n_dim + dimension];
+		}
+		if (variance > widest_variance) {
+			widest_cluster = cluster_idx;
+			widest_variance = variance;
+		}
+	}
+
+	const double* widest_variances = variances.data() + widest_cluster * n_dim;
+	size_t split_dimension = std::max_element(widest_variances, widest_variances + n_dim) - widest_variances;
+	double offset = std::sqrt(widest_variances[split_dimension]);
+
+	std::vector<double> result(centers.cbegin(), centers.cbegin() + n_clusters * n_dim);
+	result.insert(result.end(), centers.cbegin() + widest_cluster * n_dim, centers.cbegin() + (widest_cluster + 1) * n_dim);
+	result[widest_cluster * n_dim + split_dimension] -= offset;
+	result[n_clusters * n_dim + split_dimension] += offset;
+	return result;
+}
+
+struct KSweepResult {
+	size_t n_clusters;
+	double fitness;
+	uint64_t evaluations;
+	ClusterValidity validity;
+	//the centers of the champion, cluster by cluster
+	std::vector<double> centers;
+};
+
+/*
+	ColonyType - an ArtificialBeeColony whose ProblemType has get_centers, get_memberships and assign_from_centers (all
+		problem types in problems.h); the initialization of the params must not be a warm start, since the centers depend on k
+*/
+template <typename ColonyType>
+class KSweep {
+public:
+	using problem_type = typename ColonyType::problem_type;
+	using params_type = typename problem_type::params_type;
+
+	/*
+	make_colony(params) returns a std::unique_ptr to the colony for params.n_clusters clusters; it is called concurrently
+	for different k. The params are prepared once, so the colonies share the metric.
+	*/
+	template <typename MakeColony>
+	KSweep(params_type params, size_t min_clusters, size_t max_clusters, const MakeColony& make_colony, size_t n_threads = default_thread_count()):
+		min_clusters(min_clusters),
+		n_threads(n_threads) {
+
+		if (min_clusters < 1 || max_clusters < min_clusters) {
+			throw std::invalid_argument("the range of cluster counts is empty");
+		}
+
+		params = problem_type::prepare_params(params);
+		vectors = params.vectors;
+		colonies.resize(max_clusters - min_clusters + 1);
+		parallel_for(colonies.size(), 1, [&](size_t begin, size_t end) {
+			for (size_t colony_idx = begin; colony_idx < end; ++colony_idx) {
+				params_type colony_params = params;
+				colony_params.n_clusters = min_clusters + colony_idx;
+				colonies[colony_idx] = make_colony(colony_params);
+			}
+		}, n_threads);
+	}
+
+	//runs every colony for n_cycles cycles, split into n_rounds rounds separated by the seeding
+	void run(size_t n_cycles, size_t n_rounds = 4) {
+		n_rounds = std::max<size_t>(std::min(n_rounds, n_cycles), 1);
+		for (size_t round = 0; round < n_rounds; ++round) {
+			size_t round_cycles = n_cycles * (round + 1) / n_rounds - n_cycles * round / n_rounds;
+			parallel_for(colonies.size(), 1, [&](size_t begin, size_t end) {
+				for (size_t colony_idx = begin; colony_idx < end; ++colony_idx) {
+					colonies[colony_idx]->optimize(round_cycles);
+				}
+			}, n_threads);
+
+			if (round + 1 < n_rounds) {
+				seed();
+			}
+		}
+	}
+
+	//the results for every k, in increasing order
+	std::vector<KSweepResult> results() const {
+		std::vector<KSweepResult> result(colonies.size());
+		for (size_t colony_idx = 0; colony_idx < colonies.size(); ++colony_idx) {
+			const problem_type& solution = colonies[colony_idx]->get_champion().get_state();
+			const size_t n_clusters = min_clusters + colony_idx;
+			std::vector<double> memberships = solution.get_memberships();
+			std::vector<double> centers(solution.get_centers());
+			ClusterValidity validity = compute_validity(*vectors, centers, n_clusters, memberships.data());
+			result[colony_idx] = KSweepResult{ n_clusters, colonies[colony_idx]->get_champion().get_fitness(), colonies[colony_idx]->get_evaluations(), validity, std::move(centers) };
+		}
+
+		return result;
+	}
+
+	ColonyType& get_colony(size_t n_clusters) {
+		return *colonies.at(n_clusters - min_clusters);
+	}
+
+private:
+	//seeds every colony but the first one with the split champion of the previous one, in increasing order of k
+	void seed() {
+		for (size_t colony_idx = 1; colony_idx < colonies.size(); ++colony_idx) {
+			const problem_type& previous = colonies[colony_idx - 1]->get_champion().get_state();
+			const size_t previous_clusters = min_clusters + colony_idx - 1;
+			std::vector<double> memberships = previous.get_memberships();
+			colonies[colony_idx]->seed_centers(split_widest_cluster(*vectors, previous.get_centers(), previous_clusters, memberships.data()));
+		}
+	}
+
+	size_t min_clusters;
+	size_t n_threads;
+	decltype(params_type::vectors) vectors;
+	std::vector<std::unique_ptr<ColonyType>> colonies;
+};
@@ -0,0 +1,193 @@
+/*
+Tracing policies for ArtificialBeeColony. The colony calls begin/end around cycles, phases and fitness evaluations;
+NullTracingPolicy discards the calls and compiles to nothing, ChromeTracingPolicy stores them and exports a timeline
+in the Chrome trace-event JSON format (readable by chrome://tracing and Perfetto).
+*/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+class NullTracingPolicy {
+public:
+	void begin(const char*) noexcept {}
+	void end(const char*) noexcept {}
+	void finish() {}
+};
+
+/*
+Records begin/end events into fixed-size per-thread ring buffers. Every buffer has a single writer (the thread that
+owns it), so recording an event is a couple of plain stores followed by a release store of the head index. When a
+buffer is full the oldest events are overwritten.
+
+Copies of the policy share the same recorder, so several colonies may write into one timeline.
+*/
+class ChromeTracingPolicy {
+public:
+	//output_path - where finish() writes the trace; nothing is written automatically when empty
+	//capacity - the number of events kept per thread, at least 1
+	explicit ChromeTracingPolicy(std::string output_path = "", size_t capacity = 1 << 16):
+		recorder(std::make_shared<Recorder>(check_capacity(capacity))),
+		output_path(std::move(output_path)) {
+	}
+
+	void begin(const char* name) noexcept {
+		record(name, 'B');
+	}
+
+	void end(const char* name) noexcept {
+		record(name, 'E');
+	}
+
+	void finish() {
+		if (!output_path.empty()) {
+			write(output_path);
+		}
+	}
+
+	//writes all recorded events as Chrome trace-event JSON; must not run concurrently with recording threads
+	void write(const std::string& path) const {
+		std::ofstream out(path);
+		out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+		bool first = true;
+		std::lock_guard<std::mutex> lock(recorder->mutex);
+		for (const std::unique_ptr<Buffer>& buffer : recorder->buffers) {
+			uint64_t head = buffer->head.load(std::memory_order_acquire);
+			uint64_t first_event = head > buffer->events.size() ? head - buffer->events.size() : 0;
+
+			for (uint64_t event_idx = first_event; event_idx < head; ++event_idx) {
+				const Event& event = buffer->events[event_idx % buffer->events.size()];
+				if (!first) {
+					out << ',';
+				}
+				first = false;
+
+				out << "{\"name\":\"" << event.name << "\",\"ph\":\"" << event.phase << "\",\"pid\":1,\"tid\":" << buffer->thread_id
+					<< ",\"ts\":" << event.timestamp_ns / 1000 << '.' << event.timestamp_ns % 1000 / 100 << event.timestamp_ns % 100 / 10 << event.timestamp_ns % 10 << '}';
+			}
+		}
+
+		out << "]}\n";
+	}
+
+private:
+	struct Event {
+		const char* name;
+		uint64_t timestamp_ns;
+		char phase;
+	};
+
+	struct Buffer {
+		Buffer(size_t capacity, size_t thread_id) :
+			events(capacity),
+			head(0),
+			thread_id(thread_id) {
+		}
+
+		std::vector<Event> events;
+		std::atomic<uint64_t> head;
+		size_t thread_id;
+	};
+
+	struct Recorder {
+		explicit Recorder(size_t capacity) :
+			id(next_id()),
+			capacity(capacity),
+			epoch(std::chrono::steady_clock::now()) {
+		}
+
+		static uint64_t next_id() {
+			static std::atomic<uint64_t> counter(0);
+			return ++counter;
+		}
+
+		//unlike the address, the id is never reused by a later recorder
+		uint64_t id;
+		size_t capacity;
+		std::chrono::steady_clock::time_point epoch;
+		std::mutex mutex;
+		std::vector<std::unique_ptr<Buffer>> buffers;
+	};
+
+	std::shared_ptr<Recorder> recorder;
+	std::string output_path;
+
+	static size_t check_capacity(size_t capacity) {
+		if (capacity == 0) {
+			throw std::invalid_argument("the tracing capacity must be at least 1");
+		}
+		return capacity;
+	}
+
+	Buffer& local_buffer() {
+		//cache of the buffer belonging to the current thread; the mutex is only taken the first time a thread
+		//records into a given recorder (or when it alternates between recorders)
+		thread_local uint64_t cached_recorder = 0;
+		thread_local Buffer* cached_buffer = nullptr;
+
+		if (cached_recorder != recorder->id) {
+			std::lock_guard<std::mutex> lock(recorder->mutex);
+
+			thread_local std::vector<std::pair<uint64_t, Buffer*>> known_buffers;
+			auto known = std::find_if(known_buffers.cbegin(), known_buffers.cend(), [this](const auto& entry) { return entry.first == recorder->id; });
+			if (known == known_buffers.cend()) {
+				recorder->buffers.push_back(std::make_unique<Buffer>(recorder->capacity, recorder->buffers.size() + 1));
+				known_buffers.emplace_back(recorder->id, recorder->buffers.back().get());
+				known = known_buffers.cend() - 1;
+			}
+
+			cached_recorder = known->first;
+			cached_buffer = known->second;
+		}
+
+		return *cached_buffer;
+	}
+
+	//begin and end run in destructors (TraceScope) and in the middle of optimize, so the event is dropped when the
+	//first event of a thread cannot allocate its buffer instead of letting the exception escape
+	void record(const char* name, char phase) noexcept {
+		uint64_t timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - recorder->epoch).count();
+
+		Buffer* buffer;
+		try {
+			buffer = &local_buffer();
+		}
+		catch (const std::exception&) {
+			return;
+		}
+		uint64_t head = buffer->head.load(std::memory_order_relaxed);
+		buffer->events[head % buffer->events.size()] = Event{ name, timestamp, phase };
+		buffer->head.store(head + 1, std::memory_order_release);
+	}
+};
+
+//calls begin on construction and end on destruction
+template <typename TracingPolicy>
+class TraceScope {
+public:
+	TraceScope(TracingPolicy& tracing, const char* name):
+		tracing(tracing),
+		name(name) {
+		tracing.begin(name);
+	}
+
+	~TraceScope() {
+		tracing.end(name);
+	}
+
+	TraceScope(const TraceScope&) = delete;
+	TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+	TracingPolicy& tracing;
+	const char* name;
+};
@@ -0,0 +1,162 @@
+/*
+Hyperparameter tuning by successive halving: SuccessiveHalving starts a colony for every configuration with a small
+budget, keeps the best 1 / eta of them and lets the survivors continue where they left off with eta times the budget,
+until one configuration is left. With n configurations this costs about log_eta(n) complete runs instead of n.
+
+Budgets are counted in fitness evaluations rather than cycles, since a cycle of a larger population evaluates more
+solutions; a colony runs as many whole cycles as it takes to reach the budget. All colonies of a round run
+concurrently over the same dataset and metric, and all of them use the same seed, so that configurations are compared
+on the same random numbers as far as possible.
+*/
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "parallel.h"
+
+struct ColonyConfig {
+	size_t population;
+	size_t limit;
+	//the parameters of DEMixingStrategy, ignored by colonies with other mixing strategies
+	double f;
+	double mr;
+};
+
+struct TuningResult {
+	ColonyConfig config;
+	//the fitness of the champion and the evaluations when the configuration was eliminated or won
+	double fitness;
+	uint64_t evaluations;
+	//the number of rounds the configuration took part in
+	size_t rounds;
+};
+
+/*
+	ColonyType - an ArtificialBeeColony
+*/
+template <typename ColonyType>
+class SuccessiveHalving {
+public:
+	using problem_type = typename ColonyType::problem_type;
+	using params_type = typename problem_type::params_type;
+
+	/*
+	make_colony(params, config, seed) returns a std::unique_ptr to a colony with the given configuration; it is called
+	concurrently. The params are prepared once, so the colonies share the metric.
+	*/
+	template <typename MakeColony>
+	SuccessiveHalving(params_type params, std::vector<ColonyConfig> configs, uint64_t seed, const MakeColony& make_colony, size_t n_threads = default_thread_count()):
+		params(problem_type::prepare_params(params)),
+		configs(std::move(configs)),
+		seed(seed),
+		make_colony(make_colony),
+		n_threads(n_threads) {
+
+		if (this->configs.empty()) {
+			throw std::invalid_argument("at least one configuration is needed");
+		}
+		for (const ColonyConfig& config : this->configs) {
+			if (config.population < 4 || config.limit < 1) {
+				throw std::invalid_argument("every configuration needs a population of at least 4 and a positive limit");
+			}
+		}
+	}
+
+	/*
+	Runs the rounds: the first one with min_evaluations per configuration, every next one with eta times more (in
+	total, counting the evaluations of the previous rounds), keeping the best ceil(n / eta) configurations in between.
+	*/
+	void run(uint64_t min_evaluations, size_t eta = 3) {
+		if (eta < 2) {
+			throw std::invalid_argument("eta must be at least 2");
+		}
+
+		colonies.clear();
+		colonies.resize(configs.size());
+		tuning_results.assign(configs.size(), TuningResult{ ColonyConfig{}, 0.0, 0, 0 });
+		std::vector<size_t> survivors(configs.size());
+		std::iota(survivors.begin(), survivors.end(), 0);
+
+		uint64_t budget = min_evaluations;
+		for (size_t round = 1; ; ++round) {
+			parallel_for(survivors.size(), 1, [&](size_t begin, size_t end) {
+				for (size_t survivor_idx = begin; survivor_idx < end; ++survivor_idx) {
+					run_config(survivors[survivor_idx], budget, round);
+				}
+			}, n_threads);
+
+			std::stable_sort(survivors.begin(), survivors.end(), [this](size_t a, size_t b) {
+				return tuning_results[a].fitness > tuning_results[b].fitness;
+			});
+			if (survivors.size() == 1) {
+				break;
+			}
+
+			size_t n_kept = (survivors.size() + eta - 1) / eta;
+			for (size_t eliminated_idx = n_kept; eliminated_idx < survivors.size(); ++eliminated_idx) {
+				colonies[survivors[eliminated_idx]].reset();
+			}
+			survivors.resize(n_kept);
+			budget *= eta;
+		}
+
+		best_idx = survivors.front();
+	}
+
+	//one result per configuration, in the order of the configurations
+	const std::vector<TuningResult>& results() const noexcept {
+		return tuning_results;
+	}
+
+	//the winning configuration; only valid after run
+	const ColonyConfig& get_best_config() const {
+		return configs.at(best_idx);
+	}
+
+	//the colony of the winning configuration; only valid after run
+	ColonyType& get_best() {
+		if (colonies.empty() || !colonies[best_idx]) {
+			throw std::logic_error("the tuning has not been run");
+		}
+		return *colonies[best_idx];
+	}
+
+	std::unique_ptr<ColonyType> release_best() {
+		get_best();
+		return std::move(colonies[best_idx]);
+	}
+
+private:
+	//continues the colony of a configuration until it has used the budget
+	void run_config(size_t config_idx, uint64_t budget, size_t round) {
+		const ColonyConfig& config = configs[config_idx];
+		std::unique_ptr<ColonyType>& colony = colonies[config_idx];
+		if (!colony) {
+			colony = make_colony(params, config, seed);
+		}
+
+		//the employed and onlooker phases evaluate 2 solutions per bee, the scouts add a few more
+		const uint64_t evaluations_per_cycle = 2 * config.population;
+		while (colony->get_evaluations() < budget) {
+			colony->optimize((budget - colony->get_evaluations() + evaluations_per_cycle - 1) / evaluations_per_cycle);
+		}
+
+		tuning_results[config_idx] = TuningResult{ config, colony->get_champion().get_fitness(), colony->get_evaluations(), round };
+	}
+
+	params_type params;
+	std::vector<ColonyConfig> configs;
+	uint64_t seed;
+	std::function<std::unique_ptr<ColonyType>(const params_type&, const ColonyConfig&, uint64_t)> make_colony;
+	size_t n_threads;
+
+	std::vector<std::unique_ptr<ColonyType>> colonies;
+	std::vector<TuningResult> tuning_results;
+	size_t best_idx = 0;
+};
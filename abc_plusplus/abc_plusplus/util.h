@@ -7,61 +7,57 @@ Auxiliary functions
 #include <array>
 #include <cmath>
 #include <algorithm>
+#include <vector>
+#include <stdexcept>
+#include <string>
 
 template <typename RNGType>
-size_t uniform_int_except(size_t min, size_t max, size_t excluded, RNGType rng) {
+size_t uniform_int_except(size_t min, size_t max, size_t excluded, RNGType& rng) {
 	std::uniform_int_distribution<size_t> dist(min, max - 1);
 	size_t random = dist(rng);
 	return random < excluded ? random : random + 1;
 }
 
+//distinct numbers from [min, max]; uses rejection sampling, so count should be small compared to the range
 template <size_t count, typename RNGType>
-std::array<size_t, count> uniform_ints(size_t min, size_t max, RNGType rng) {
-	static std::vector<size_t> numbers;
-	if (numbers.size() != max - min + 1) {
-		numbers.resize(max - min + 1);
-		for (size_t i = 0; i < numbers.size(); ++i) {
-			numbers[i] = i;
-		}
+std::array<size_t, count> uniform_ints(size_t min, size_t max, RNGType& rng) {
+	if (count > 0 && (max < min || max - min < count - 1)) {
+		throw std::invalid_argument("fewer than " + std::to_string(count) + " numbers to draw from");
 	}
+	std::uniform_int_distribution<size_t> dist(min, max);
 
 	std::array<size_t, count> result;
 	for (size_t i = 0; i < count; ++i) {
-		std::uniform_int_distribution<size_t> dist(i, max - min);
-		size_t random = dist(rng);
-
-		result[i] = numbers[random];
-		std::swap(numbers[random], numbers[i]);
+		do {
+			result[i] = dist(rng);
+		} while (std::find(result.begin(), result.begin() + i, result[i]) != result.begin() + i);
 	}
 
 	return result;
 }
 
+//distinct numbers from [min, max], drawn with a partial Fisher-Yates shuffle
 template <typename RNGType>
-std::vector<size_t> uniform_ints(size_t min, size_t max, size_t count, RNGType rng) {
-	static std::vector<size_t> numbers;
-	if (numbers.size() != max - min + 1) {
-		numbers.resize(max - min + 1);
-		for (size_t i = 0; i < numbers.size(); ++i) {
-			numbers[i] = i;
-		}
+std::vector<size_t> uniform_ints(size_t min, size_t max, size_t count, RNGType& rng) {
+	if (count > 0 && (max < min || max - min < count - 1)) {
+		throw std::invalid_argument("fewer than " + std::to_string(count) + " numbers to draw from");
+	}
+	std::vector<size_t> numbers(max - min + 1);
+	for (size_t i = 0; i < numbers.size(); ++i) {
+		numbers[i] = min + i;
 	}
 
-	std::vector<size_t> result;
-	result.resize(count);
 	for (size_t i = 0; i < count; ++i) {
-		std::uniform_int_distribution<size_t> dist(i, max - min);
-		size_t random = dist(rng);
-
-		result[i] = numbers[random];
-		std::swap(numbers[random], numbers[i]);
+		std::uniform_int_distribution<size_t> dist(i, numbers.size() - 1);
+		std::swap(numbers[dist(rng)], numbers[i]);
 	}
 
-	return result;
+	numbers.resize(count);
+	return numbers;
 }
 
 template <size_t count, typename RNGType>
-std::array<size_t, count> uniform_ints_except(size_t min, size_t max, size_t excluded, RNGType rng) {
+std::array<size_t, count> uniform_ints_except(size_t min, size_t max, size_t excluded, RNGType& rng) {
 	std::array<size_t, count> result = uniform_ints<count, RNGType>(min, max - 1, rng);
 	for (size_t& number: result) {
 		if (number >= excluded) {
@@ -169,6 +165,20 @@ void elementwise_multiply(ArrayIterType array_begin, OutputIterType output_begin
 	}
 }
 
+template <typename IterType1, typename IterType2>
+double squared_euclidean_dist(IterType1 begin1, IterType1 end1, IterType2 begin2) {
+	double result = 0.0;
+	while (begin1 != end1) {
+		double diff = *begin1 - *begin2;
+		result += diff * diff;
+
+		++begin1;
+		++begin2;
+	}
+
+	return result;
+}
+
 template <typename IterType1, typename IterType2>
 double euclidean_dist(IterType1 begin1, IterType1 end1, IterType2 begin2) {
 	double result = 0.0;
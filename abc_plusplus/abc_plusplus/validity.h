@@ -0,0 +1,246 @@
+/*
+Quality indices of fuzzy partitions. The internal validity indices compare clusterings with different numbers of
+clusters (see sweep.h):
+	partition coefficient - (1 / n) sum_ij u_ij^2, between 1 / k and 1, higher is crisper
+	partition entropy - -(1 / n) sum_ij u_ij log u_ij, between 0 and log k, lower is crisper
+	Xie-Beni index - sum_ij u_ij^2 |x_i - c_j|^2 / (n min_{j != l} |c_j - c_l|^2), compactness over separation, lower is
+		better
+The external indices compare a clustering with the ground truth (see ground_truth.h):
+	fuzzy adjusted Rand index - the adjusted Rand index of the fuzzy contingency table n_jl = sum_i u_ij v_il, equal to
+		the usual one for crisp partitions; 1 for identical partitions, around 0 for random ones
+	centroid index - the number of true centers without a matching center (or vice versa, whichever is larger), where
+		every center is matched to the nearest one of the other set; 0 when the cluster structure is found
+
+The memberships are given point by point (n by k), as returned by get_memberships of the problem types. The indices
+are computed by multiple threads, a block of vectors at a time.
+*/
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+#include "distances.h"
+#include "parallel.h"
+
+//the number of vectors processed by a single thread at a time
+constexpr size_t validity_grain = 16 * distance_block_size;
+
+struct ClusterValidity {
+	double partition_coefficient;
+	double partition_entropy;
+	double xie_beni;
+};
+
+template <size_t n_dim, typename Scalar>
+ClusterValidity compute_validity(const std::vector<std::array<Scalar, n_dim>>& vectors, const std::vector<double>& centers, size_t n_clusters, const double* memberships) {
+	const size_t n_vectors = vectors.size();
+	ClusterValidity result{ 0.0, 0.0, 0.0 };
+	double compactness = 0.0;
+	std::mutex result_mutex;
+
+	//the Xie-Beni index is defined with Euclidean distances regardless of the metric of the problem
+	const SquaredEuclideanMetric metric(vectors);
+	const PreparedCenters prepared_centers = metric.prepare_centers<n_dim>(centers.data(), n_clusters);
+
+	parallel_for(n_vectors, validity_grain, [&](size_t begin, size_t end) {
+		std::vector<double> distances(distance_block_size * n_clusters);
+		ClusterValidity partial{ 0.0, 0.0, 0.0 };
+		double partial_compactness = 0.0;
+
+		for (size_t block_begin = begin; block_begin < end; block_begin += distance_block_size) {
+			size_t block_vectors = std::min(distance_block_size, end - block_begin);
+			metric.distance_block(block_begin, vectors.data() + block_begin, block_vectors, prepared_centers, distances.data());
+
+			for (size_t value_idx = 0; value_idx < block_vectors * n_clusters; ++value_idx) {
+				double membership = memberships[block_begin * n_clusters + value_idx];
+				partial.partition_coefficient += membership * membership;
+				if (membership > 0.0) {
+					partial.partition_entropy -= membership * std::log(membership);
+				}
+				partial_compactness += membership * membership * distances[value_idx];
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(result_mutex);
+		result.partition_coefficient += partial.partition_coefficient;
+		result.partition_entropy += partial.partition_entropy;
+		compactness += partial_compactness;
+	});
+
+	double separation = std::numeric_limits<double>::infinity();
+	for (size_t cluster_idx = 0; cluster_idx < n_clusters; ++cluster_idx) {
+		for (size_t other_idx = cluster_idx + 1; other_idx < n_clusters; ++other_idx) {
+			double squared_dist = 0.0;
+			for (size_t dimension = 0; dimension < n_dim; ++dimension) {
+				double diff = centers[cluster_idx * n_dim + dimension] - centers[other_idx * n_dim + dimension];
+				squared_dist += diff * diff;
+			}
+			separation = std::min(separation, squared_dist);
+		}
+	}
+
+	result.partition_coefficient /= n_vectors;
+	result.partition_entropy /= n_vectors;
+	result.xie_beni = compactness / (n_vectors * separation);
+	return result;
+}
+
+/*
+The contingency table (n_clusters by n_reference_clusters) of the memberships and a reference;
+add_reference_row(i, u, row) adds the reference memberships of vector i, multiplied by u, to the row.
+*/
+template <typename ReferenceRow>
+std::vector<double> fuzzy_contingency(const double* memberships, size_t n_vectors, size_t n_clusters, size_t n_reference_clusters, const ReferenceRow& add_reference_row) {
+	std::vector<double> result(n_clusters * n_reference_clusters);
+	std::mutex result_mutex;
+
+	parallel_for(n_vectors, validity_grain, [&](size_t begin, size_t end) {
+		std::vector<double> partial(result.size());
+		for (size_t vector_idx = begin; vector_idx < end; ++vector_idx) {
+			for (size_t cluster_idx = 0; cluster_idx < n_clusters; ++cluster_idx) {
+				double membership = memberships[vector_idx * n_clusters + cluster_idx];
+				if (membership != 0.0) {
+					add_reference_row(vector_idx, membership, partial.data() + cluster_idx * n_reference_clusters);
+				}
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(result_mutex);
+		for (size_t value_idx = 0; value_idx < result.size(); ++value_idx) {
+			result[value_idx] += partial[value_idx];
+		}
+	});
+
+	return result;
+}
+
+//the adjusted Rand index of a (possibly fuzzy) contingency table with n_cols columns
+inline double adjusted_rand_index(const std::vector<double>& contingency, size_t n_cols) {
+	auto pairs = [](double count) { return count * (count - 1.0) / 2.0; };
+
+	const size_t n_rows = contingency.size() / n_cols;
+	std::vector<double> row_sums(n_rows), col_sums(n_cols);
+	double pair_sum = 0.0;
+	for (size_t row = 0; row < n_rows; ++row) {
+		for (size_t col = 0; col < n_cols; ++col) {
+			double count = contingency[row * n_cols + col];
+			pair_sum += pairs(count);
+			row_sums[row] += count;
+			col_sums[col] += count;
+		}
+	}
+
+	double total = 0.0, row_pairs = 0.0, col_pairs = 0.0;
+	for (double row_sum : row_sums) {
+		total += row_sum;
+		row_pairs += pairs(row_sum);
+	}
+	for (double col_sum : col_sums) {
+		col_pairs += pairs(col_sum);
+	}
+
+	double expected = row_pairs * col_pairs / pairs(total);
+	double maximum = (row_pairs + col_pairs) / 2.0;
+	return maximum == expected ? 1.0 : (pair_sum - expected) / (maximum - expected);
+}
+
+//the fuzzy adjusted Rand index against a fuzzy reference given point by point (n by n_reference_clusters)
+inline double fuzzy_adjusted_rand_index(const double* memberships, size_t n_vectors, size_t n_clusters, const double* reference, size_t n_reference_clusters) {
+	std::vector<double> contingency = fuzzy_contingency(memberships, n_vectors, n_clusters, n_reference_clusters, [&](size_t vector_idx, double membership, double* row) {
+		const double* reference_memberships = reference + vector_idx * n_reference_clusters;
+		for (size_t reference_idx = 0; reference_idx < n_reference_clusters; ++reference_idx) {
+			row[reference_idx] += membership * reference_memberships[reference_idx];
+		}
+	});
+
+	return adjusted_rand_index(contingency, n_reference_clusters);
+}
+
+//the fuzzy adjusted Rand index against crisp 0-based reference labels
+inline double fuzzy_adjusted_rand_index(const double* memberships, size_t n_vectors, size_t n_clusters, const int64_t* labels) {
+	const size_t n_reference_clusters = n_vectors > 0 ? *std::max_element(labels, labels + n_vectors) + 1 : 0;
+	std::vector<double> contingency = fuzzy_contingency(memberships, n_vectors, n_clusters, n_reference_clusters, [&](size_t vector_idx, double membership, double* row) {
+		row[labels[vector_idx]] += membership;
+	});
+
+	return adjusted_rand_index(contingency, n_reference_clusters);
+}
+
+//the number of centers of to that are not the nearest one of any center of from
+inline size_t centroid_orphans(const std::vector<double>& from, const std::vector<double>& to, size_t n_dim) {
+	const size_t n_to = to.size() / n_dim;
+	std::vector<bool> matched(n_to, false);
+	for (size_t from_idx = 0; from_idx < from.size() / n_dim; ++from_idx) {
+		size_t nearest = 0;
+		double nearest_dist = std::numeric_limits<double>::infinity();
+		for (size_t to_idx = 0; to_idx < n_to; ++to_idx) {
+			double dist = squared_euclidean_dist(from.cbegin() + from_idx * n_dim, from.cbegin() + (from_idx + 1) * n_dim, to.cbegin() + to_idx * n_dim);
+			if (dist < nearest_dist) {
+				nearest = to_idx;
+				nearest_dist = dist;
+			}
+		}
+		matched[nearest] = true;
+	}
+
+	return std::count(matched.cbegin(), matched.cend(), false);
+}
+
+//the centroid index of two sets of centers, both stored center by center
+inline size_t centroid_index(const std::vector<double>& centers, const std::vector<double>& reference_centers, size_t n_dim) {
+	return std::max(centroid_orphans(centers, reference_centers, n_dim), centroid_orphans(reference_centers, centers, n_dim));
+}
+
+//the ground truth a clustering is compared with; every part is optional
+struct ClusteringReference {
+	//0-based labels, one per vector
+	std::vector<int64_t> labels;
+	//n_clusters memberships per vector, vector by vector
+	std::vector<double> memberships;
+	size_t n_clusters = 0;
+	//center by center
+	std::vector<double> centers;
+};
+
+struct ClusteringQuality {
+	ClusterValidity validity;
+	//against the reference labels and the reference memberships, NaN without them
+	double adjusted_rand_index;
+	double fuzzy_adjusted_rand_index;
+	//against the reference centers, -1 without them
+	int64_t centroid_index;
+};
+
+/*
+All indices of a solution, computed from its own memberships and centers (get_memberships and get_centers of the
+problem types). Cheap enough to be computed for the champion every few cycles, see ArtificialBeeColony::set_monitor.
+*/
+template <typename ProblemType, size_t n_dim, typename Scalar>
+ClusteringQuality evaluate_quality(const ProblemType& solution, const std::vector<std::array<Scalar, n_dim>>& vectors, const ClusteringReference& reference) {
+	const size_t n_clusters = solution.get_n_clusters();
+	const std::vector<double> memberships = solution.get_memberships();
+	const std::vector<double> centers(solution.get_centers());
+
+	ClusteringQuality result;
+	result.validity = compute_validity(vectors, centers, n_clusters, memberships.data());
+	result.adjusted_rand_index = std::numeric_limits<double>::quiet_NaN();
+	result.fuzzy_adjusted_rand_index = std::numeric_limits<double>::quiet_NaN();
+	result.centroid_index = -1;
+
+	if (reference.labels.size() == vectors.size()) {
+		result.adjusted_rand_index = fuzzy_adjusted_rand_index(memberships.data(), vectors.size(), n_clusters, reference.labels.data());
+	}
+	if (reference.n_clusters > 0 && reference.memberships.size() == vectors.size() * reference.n_clusters) {
+		result.fuzzy_adjusted_rand_index = fuzzy_adjusted_rand_index(memberships.data(), vectors.size(), n_clusters, reference.memberships.data(), reference.n_clusters);
+	}
+	if (!reference.centers.empty()) {
+		result.centroid_index = centroid_index(centers, reference.centers, n_dim);
+	}
+
+	return result;
+}
@@ -0,0 +1,418 @@
+/*
+Micro-benchmarks of the hot kernels on the bundled datasets (data/dim_set and data/worms):
+	compute_fitness - one evaluation of FuzzyClustering
+	get_gene, set_gene, repair - the gene accessors and FuzzyClusteringGene::repair
+	classic_mix, de_mix - ClassicMixingStrategy::mix and DEMixingStrategy::mix, including the copy of the solution
+	roulette_select, tournament_select - one selection from a swarm, for several populations
+	optimize_abc, optimize_modabc - a fixed number of cycles of the classic and the modified colony
+Every dataset is run with half, once and twice its true number of clusters.
+
+The harness follows Google Benchmark, which is not a dependency of the project: the number of iterations grows until a
+batch runs for at least the minimum time, items_per_second counts evaluations (or calls of the kernel) and
+bytes_per_second the memberships and vectors they touch. The JSON output has the format of Google Benchmark, so it can
+be compared with its tools/compare.py.
+
+	benchmark [--data_dir=DIR] [--benchmark_filter=REGEX] [--benchmark_min_time=SECONDS] [--benchmark_out=FILE.json]
+		[--cycles=N]
+*/
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <regex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "abc.h"
+
+//keeps the compiler from optimizing away a result that is never read
+template <typename T>
+void keep(const T& value) {
+#if defined(__GNUC__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	static volatile const void* sink;
+	sink = &value;
+#endif
+}
+
+struct BenchmarkResult {
+	std::string name;
+	uint64_t iterations;
+	//per iteration
+	double real_ns;
+	double cpu_ns;
+	double items_per_second;
+	double bytes_per_second;
+};
+
+class BenchmarkRunner {
+public:
+	BenchmarkRunner(const std::string& filter, double min_time):
+		filter(filter),
+		min_time(min_time) {
+
+	}
+
+	bool enabled(const std::string& name) const {
+		return std::regex_search(name, filter);
+	}
+
+	/*
+	Runs body, which returns the number of items it processed, in batches of a growing number of iterations until a
+	batch takes at least the minimum time; the last batch is reported.
+	*/
+	template <typename Body>
+	void run(const std::string& name, double bytes_per_item, Body&& body) {
+		if (!enabled(name)) {
+			return;
+		}
+
+		uint64_t iterations = 1;
+		while (true) {
+			double items = 0.0;
+			std::clock_t cpu_start = std::clock();
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			for (uint64_t iteration = 0; iteration < iterations; ++iteration) {
+				items += body();
+			}
+			double real_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			double cpu_seconds = double(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+
+			if (real_seconds >= min_time || iterations >= max_iterations) {
+				BenchmarkResult result{ name, iterations, real_seconds * 1e9 / iterations, cpu_seconds * 1e9 / iterations, items / real_seconds, items * bytes_per_item / real_seconds };
+				print(result);
+				results.push_back(result);
+				return;
+			}
+
+			//the same growth rule as Google Benchmark: aim 40% past the minimum time, at most 10 times more iterations
+			double multiplier = real_seconds > 0.0 ? min_time * 1.4 / real_seconds : 10.0;
+			iterations = std::max(iterations + 1, uint64_t(iterations * std::min(multiplier, 10.0)));
+		}
+	}
+
+	void write_json(std::ostream& out, const std::string& executable) const {
+		std::time_t now = std::time(nullptr);
+		char date[32];
+		std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+		out << std::setprecision(17);
+		out << "{\n  \"context\": {\n";
+		out << "    \"date\": \"" << date << "\",\n";
+		out << "    \"executable\": \"" << escape(executable) << "\",\n";
+		out << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+#ifdef NDEBUG
+		out << "    \"library_build_type\": \"release\"\n";
+#else
+		out << "    \"library_build_type\": \"debug\"\n";
+#endif
+		out << "  },\n  \"benchmarks\": [";
+		for (size_t result_idx = 0; result_idx < results.size(); ++result_idx) {
+			const BenchmarkResult& result = results[result_idx];
+			out << (result_idx > 0 ? "," : "") << "\n    {\n";
+			out << "      \"name\": \"" << escape(result.name) << "\",\n";
+			out << "      \"run_name\": \"" << escape(result.name) << "\",\n";
+			out << "      \"run_type\": \"iteration\",\n";
+			out << "      \"repetitions\": 1,\n";
+			out << "      \"repetition_index\": 0,\n";
+			out << "      \"threads\": 1,\n";
+			out << "      \"iterations\": " << result.iterations << ",\n";
+			out << "      \"real_time\": " << result.real_ns << ",\n";
+			out << "      \"cpu_time\": " << result.cpu_ns << ",\n";
+			out << "      \"time_unit\": \"ns\",\n";
+			out << "      \"bytes_per_second\": " << result.bytes_per_second << ",\n";
+			out << "      \"items_per_second\": " << result.items_per_second << "\n";
+			out << "    }";
+		}
+		out << "\n  ]\n}\n";
+	}
+
+	static void print_header() {
+		std::cout << std::left << std::setw(name_width) << "Benchmark" << std::right << std::setw(15) << "Time" << std::setw(15) << "CPU" << std::setw(12) << "Iterations" << "  UserCounters...\n";
+		std::cout << std::string(name_width + 42 + 40, '-') << '\n';
+	}
+
+private:
+	static void print(const BenchmarkResult& result) {
+		std::cout << std::left << std::setw(name_width) << result.name << std::right << std::fixed << std::setprecision(0)
+			<< std::setw(12) << result.real_ns << " ns" << std::setw(12) << result.cpu_ns << " ns" << std::setw(12) << result.iterations
+			<< "  bytes_per_second=" << human_readable(result.bytes_per_second) << "B/s"
+			<< " items_per_second=" << human_readable(result.items_per_second) << "/s" << std::endl;
+	}
+
+	static std::string human_readable(double value) {
+		const char* prefixes[] = { "", "k", "M", "G", "T" };
+		size_t prefix = 0;
+		while (value >= 1000.0 && prefix + 1 < sizeof(prefixes) / sizeof(prefixes[0])) {
+			value /= 1000.0;
+			++prefix;
+		}
+
+		std::ostringstream result;
+		result << std::fixed << std::setprecision(value < 10.0 ? 3 : value < 100.0 ? 2 : 1) << value << prefixes[prefix];
+		return result.str();
+	}
+
+	static std::string escape(const std::string& text) {
+		std::string result;
+		for (char character : text) {
+			if (character == '"' || character == '\\') {
+				result += '\\';
+			}
+			result += character;
+		}
+
+		return result;
+	}
+
+	static constexpr int name_width = 44;
+	static constexpr uint64_t max_iterations = 1000000000;
+
+	std::regex filter;
+	double min_time;
+	std::vector<BenchmarkResult> results;
+};
+
+struct BenchmarkSettings {
+	size_t cycles = 10;
+	size_t population = 10;
+	size_t limit = 100;
+	uint64_t seed = 42;
+};
+
+template <size_t n_dim>
+void benchmark_dataset(BenchmarkRunner& runner, const BenchmarkSettings& settings, const std::string& dataset, const std::vector<double>& values, size_t true_clusters) {
+	using Problem = FuzzyClustering<n_dim>;
+
+	std::vector<std::array<double, n_dim>> vectors(values.size() / n_dim);
+	for (size_t vector_idx = 0; vector_idx < vectors.size(); ++vector_idx) {
+		std::copy(values.cbegin() + vector_idx * n_dim, values.cbegin() + (vector_idx + 1) * n_dim, vectors[vector_idx].begin());
+	}
+	const size_t n_vectors = vectors.size();
+
+	for (size_t n_clusters : { std::max<size_t>(true_clusters / 2, 2), true_clusters, 2 * true_clusters }) {
+		const std::string suffix = "/" + dataset + "/k:" + std::to_string(n_clusters);
+		const double membership_bytes = double(n_vectors * n_clusters * sizeof(double));
+		const double vector_bytes = double(n_vectors * n_dim * sizeof(double));
+		const double gene_bytes = double(n_clusters * sizeof(double));
+
+		FuzzyClusteringParams<n_dim> params{ n_clusters, &vectors, nullptr, nullptr, NumaPlacement::none, nullptr, nullptr, nullptr };
+		params = Problem::prepare_params(params);
+
+		std::mt19937_64 rng(settings.seed);
+		Problem problem(params, rng);
+		const Problem champion(params, rng), buddy1(params, rng), buddy2(params, rng), buddy3(params, rng);
+
+		//the memberships are read twice, once for the centers and once for the distances
+		runner.run("compute_fitness" + suffix, 2.0 * membership_bytes + vector_bytes, [&] {
+			keep(problem.compute_fitness());
+			return 1.0;
+		});
+
+		size_t gene_idx = 0;
+		runner.run("get_gene" + suffix, gene_bytes, [&] {
+			keep(problem.get_gene(gene_idx));
+			gene_idx = gene_idx + 1 < n_vectors ? gene_idx + 1 : 0;
+			return 1.0;
+		});
+
+		const FuzzyClusteringGene gene = buddy1.get_gene(0);
+		runner.run("set_gene" + suffix, gene_bytes, [&] {
+			problem.set_gene(gene_idx, gene);
+			gene_idx = gene_idx + 1 < n_vectors ? gene_idx + 1 : 0;
+			return 1.0;
+		});
+
+		const FuzzyClusteringGene unrepaired = gene + 2.0 * (buddy1.get_gene(1) - buddy2.get_gene(2));
+		runner.run("repair" + suffix, gene_bytes, [&] {
+			FuzzyClusteringGene repaired = unrepaired;
+			repaired.repair();
+			keep(repaired);
+			return 1.0;
+		});
+
+		ClassicMixingStrategy<Problem> classic_mixing;
+		runner.run("classic_mix" + suffix, membership_bytes, [&] {
+			keep(classic_mixing.mix(problem, buddy1, rng));
+			return 1.0;
+		});
+
+		DEMixingStrategy<Problem> de_mixing(0.8, 0.1);
+		runner.run("de_mix" + suffix, membership_bytes, [&] {
+			keep(de_mixing.mix(problem, champion, buddy1, buddy2, buddy3, rng));
+			return 1.0;
+		});
+
+		//an evaluation reads the memberships and the vectors, as in compute_fitness
+		const double evaluation_bytes = 2.0 * membership_bytes + vector_bytes;
+		if (runner.enabled("optimize_abc" + suffix)) {
+			ABCFuzzyClustering<n_dim> colony{ params, settings.population, settings.limit, ClassicMixingStrategy<Problem>(), RouletteSelectionStrategy(), std::mt19937_64(settings.seed) };
+			runner.run("optimize_abc" + suffix, evaluation_bytes, [&] {
+				uint64_t evaluations = colony.get_evaluations();
+				colony.optimize(settings.cycles);
+				return double(colony.get_evaluations() - evaluations);
+			});
+		}
+		if (runner.enabled("optimize_modabc" + suffix)) {
+			ModABCFuzzyClustering<n_dim> colony{ params, settings.population, settings.limit, DEMixingStrategy<Problem>(0.8, 0.1), RouletteSelectionStrategy(), std::mt19937_64(settings.seed) };
+			runner.run("optimize_modabc" + suffix, evaluation_bytes, [&] {
+				uint64_t evaluations = colony.get_evaluations();
+				colony.optimize(settings.cycles);
+				return double(colony.get_evaluations() - evaluations);
+			});
+		}
+	}
+}
+
+//the selection only reads the fitness of the bees, so it is benchmarked on a tiny dataset for several populations
+void benchmark_selection(BenchmarkRunner& runner, const BenchmarkSettings& settings) {
+	using Problem = FuzzyClustering<2>;
+	using BeeType = Bee<Problem, ClassicMixingStrategy<Problem>>;
+
+	std::vector<std::array<double, 2>> vectors(16);
+	std::mt19937_64 rng(settings.seed);
+	std::uniform_real_distribution<double> coordinate_dist(0.0, 1.0);
+	for (std::array<double, 2>& vector : vectors) {
+		vector = { coordinate_dist(rng), coordinate_dist(rng) };
+	}
+
+	FuzzyClusteringParams<2> params{ 2, &vectors, nullptr, nullptr, NumaPlacement::none, nullptr, nullptr, nullptr };
+	params = Problem::prepare_params(params);
+
+	for (size_t population : { 10, 20, 50, 100 }) {
+		const std::string suffix = "/population:" + std::to_string(population);
+		std::vector<BeeType> swarm;
+		double all_nectar = 0.0;
+		for (size_t bee_idx = 0; bee_idx < population; ++bee_idx) {
+			swarm.emplace_back(settings.limit, Problem(params, rng), ClassicMixingStrategy<Problem>());
+			all_nectar += swarm.back().get_fitness();
+		}
+
+		//the tournament size depends on the cycle, so the benchmark walks through all of them
+		const size_t n_cycles = 1000;
+		size_t iteration = 0;
+
+		RouletteSelectionStrategy roulette;
+		roulette.set_size(population, n_cycles);
+		runner.run("roulette_select" + suffix, 0.0, [&] {
+			keep(roulette.select(all_nectar, swarm, iteration, rng));
+			return 1.0;
+		});
+
+		TournamentSelectionStrategy tournament;
+		tournament.set_size(population, n_cycles);
+		runner.run("tournament_select" + suffix, 0.0, [&] {
+			keep(tournament.select(all_nectar, swarm, iteration, rng));
+			iteration = iteration + 1 < n_cycles ? iteration + 1 : 0;
+			return 1.0;
+		});
+	}
+}
+
+void benchmark_dataset(BenchmarkRunner& runner, const BenchmarkSettings& settings, const std::string& dataset, const std::vector<double>& values, size_t n_dim, size_t true_clusters) {
+	switch (n_dim) {
+	case 2: benchmark_dataset<2>(runner, settings, dataset, values, true_clusters); break;
+	case 32: benchmark_dataset<32>(runner, settings, dataset, values, true_clusters); break;
+	case 64: benchmark_dataset<64>(runner, settings, dataset, values, true_clusters); break;
+	case 128: benchmark_dataset<128>(runner, settings, dataset, values, true_clusters); break;
+	case 256: benchmark_dataset<256>(runner, settings, dataset, values, true_clusters); break;
+	case 512: benchmark_dataset<512>(runner, settings, dataset, values, true_clusters); break;
+	case 1024: benchmark_dataset<1024>(runner, settings, dataset, values, true_clusters); break;
+	default: throw std::invalid_argument("no benchmark instantiated for " + std::to_string(n_dim) + " dimensions");
+	}
+}
+
+struct Dataset {
+	std::string name;
+	std::string vectors_path;
+	std::string partition_path;
+};
+
+bool file_exists(const std::string& path) {
+	return std::ifstream(path).good();
+}
+
+int main(int argc, char** argv) {
+	std::string data_dir = "../../data";
+	std::string filter = ".";
+	std::string out_path;
+	double min_time = 0.5;
+	BenchmarkSettings settings;
+
+	for (int arg_idx = 1; arg_idx < argc; ++arg_idx) {
+		std::string arg = argv[arg_idx];
+		std::string value = arg.substr(arg.find('=') + 1);
+		if (arg.rfind("--data_dir=", 0) == 0) {
+			data_dir = value;
+		}
+		else if (arg.rfind("--benchmark_filter=", 0) == 0) {
+			filter = value;
+		}
+		else if (arg.rfind("--benchmark_min_time=", 0) == 0) {
+			min_time = std::stod(value);
+		}
+		else if (arg.rfind("--benchmark_out=", 0) == 0) {
+			out_path = value;
+		}
+		else if (arg.rfind("--cycles=", 0) == 0) {
+			settings.cycles = std::stoul(value);
+		}
+		else {
+			std::cerr << "usage: " << argv[0] << " [--data_dir=DIR] [--benchmark_filter=REGEX] [--benchmark_min_time=SECONDS] [--benchmark_out=FILE.json] [--cycles=N]\n";
+			return 1;
+		}
+	}
+
+	const std::vector<Dataset> datasets = {
+		{ "dim032", data_dir + "/dim_set/dim032.txt", data_dir + "/dim_set/dim032.pa.txt" },
+		{ "dim064", data_dir + "/dim_set/dim064.txt", data_dir + "/dim_set/dim064.pa.txt" },
+		{ "dim128", data_dir + "/dim_set/dim128.txt", data_dir + "/dim_set/dim128.pa.txt" },
+		{ "dim256", data_dir + "/dim_set/dim256.txt", data_dir + "/dim_set/dim256.pa.txt" },
+		{ "dim512", data_dir + "/dim_set/dim512.txt", data_dir + "/dim_set/dim512.pa.txt" },
+		{ "dim1024", data_dir + "/dim_set/dim1024.txt", data_dir + "/dim_set/dim1024.pa.txt" },
+		{ "worms_2d", data_dir + "/worms/worms_2d.txt", data_dir + "/worms/worms_2d-gt.pa" },
+		{ "worms_64d_sample", data_dir + "/worms/worms_64d_sample.txt", data_dir + "/worms/worms_64d_sample-gt.pa" },
+	};
+
+	BenchmarkRunner runner(filter, min_time);
+	BenchmarkRunner::print_header();
+	try {
+		benchmark_selection(runner, settings);
+
+		for (const Dataset& dataset : datasets) {
+			if (!file_exists(dataset.vectors_path) || !file_exists(dataset.partition_path)) {
+				std::cerr << "skipping " << dataset.name << ": " << dataset.vectors_path << " or " << dataset.partition_path << " not found\n";
+				continue;
+			}
+
+			size_t n_dim = 0;
+			std::vector<double> values = read_text_matrix(dataset.vectors_path, n_dim);
+			std::vector<int64_t> labels = read_partition(dataset.partition_path);
+			size_t true_clusters = labels.empty() ? 1 : size_t(*std::max_element(labels.cbegin(), labels.cend()) + 1);
+			benchmark_dataset(runner, settings, dataset.name, values, n_dim, true_clusters);
+		}
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << '\n';
+		return 1;
+	}
+
+	if (!out_path.empty()) {
+		std::ofstream out(out_path);
+		runner.write_json(out, argv[0]);
+		if (!out) {
+			std::cerr << "cannot write " << out_path << '\n';
+			return 1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,101 @@
+/*
+Test of SparseFuzzyClustering (problems.h) with a cluster that is no vector's membership, which is a normal state with
+few memberships per vector: the centers must stay finite, refine must not lose the clusters it has, and predict,
+transform and appending vectors must work with the centers. Built from the abc_plusplus directory with
+
+	g++ -std=c++17 -O1 -g -pthread -Iabc_plusplus tests/sparse_empty_cluster.cpp abc_plusplus/problems.cpp abc_plusplus/numa.cpp abc_plusplus/parallel.cpp abc_plusplus/sharded.cpp abc_plusplus/dataset.cpp abc_plusplus/npy.cpp abc_plusplus/ground_truth.cpp -o sparse_empty_cluster
+
+and run without arguments. Exits with 1 and a message on the first failed check.
+*/
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "problems.h"
+#include "predict.h"
+
+namespace {
+	using Problem = SparseFuzzyClustering<2>;
+
+	bool failed = false;
+
+	void check(bool condition, const std::string& message) {
+		if (!condition && !failed) {
+			std::cerr << message << std::endl;
+			failed = true;
+		}
+	}
+
+	bool all_finite(const std::vector<double>& values) {
+		for (double value : values) {
+			if (!std::isfinite(value)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	//three groups of points around (0, 0), (10, 0) and (0, 10), the last group in two parts
+	std::vector<std::array<double, 2>> make_vectors() {
+		std::vector<std::array<double, 2>> result;
+		for (size_t idx = 0; idx < 20; ++idx) {
+			const double offset = 0.1 * static_cast<double>(idx % 5);
+			switch (idx % 3) {
+			case 0: result.push_back({ offset, offset }); break;
+			case 1: result.push_back({ 10 + offset, offset }); break;
+			default: result.push_back({ idx < 10 ? offset : 4 + offset, 10 + offset }); break;
+			}
+		}
+		return result;
+	}
+
+	//every vector fully in the cluster of its group, cluster 3 empty
+	std::vector<SparseMembership<double>> make_memberships(size_t n_vectors) {
+		std::vector<SparseMembership<double>> result;
+		for (size_t idx = 0; idx < n_vectors; ++idx) {
+			result.push_back({ static_cast<uint32_t>(idx % 3), 1.0 });
+		}
+		return result;
+	}
+}
+
+int main() {
+	std::vector<std::array<double, 2>> vectors = make_vectors();
+	SparseFuzzyClusteringParams<2> params{ 4, &vectors, 1, nullptr, nullptr, nullptr };
+	params = Problem::prepare_params(params);
+
+	Problem solution(params, make_memberships(vectors.size()));
+	const std::vector<double> centers = solution.get_centers();
+	check(all_finite(centers), "the center of the empty cluster is not finite");
+
+	const double fitness = solution.compute_fitness();
+	solution.refine(1);
+	check(std::isfinite(solution.compute_fitness()) && solution.compute_fitness() >= fitness, "refine lowered the fitness");
+	check(all_finite(solution.get_centers()), "refine left a center that is not finite");
+
+	std::vector<int64_t> labels(vectors.size());
+	assign_labels(solution, vectors, labels.data());
+	check(std::set<int64_t>(labels.cbegin(), labels.cend()).size() == 4, "predict does not use all 4 clusters after refine");
+
+	std::vector<double> memberships(vectors.size() * 4);
+	assign_memberships(solution, vectors, 2.0, memberships.data());
+	check(all_finite(memberships), "transform returned memberships that are not finite");
+
+	//appending to a solution that still has the empty cluster
+	Problem appended(params, make_memberships(vectors.size()));
+	params = Problem::extend_params(params, { { 5, 5 }, { 0.2, 0.1 } });
+	appended.append_vectors(params);
+	check(appended.gene_count() == vectors.size() + 2, "append_vectors did not extend the solution");
+	check(all_finite(appended.get_centers()) && std::isfinite(appended.compute_fitness()), "append_vectors produced centers that are not finite");
+
+	if (failed) {
+		return EXIT_FAILURE;
+	}
+	std::cout << "the empty cluster was re-seeded" << std::endl;
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,102 @@
+/*
+Stress test of the thread pool (parallel.h): several threads run nested parallel_for loops on the shared pool while
+another one keeps resizing it and switching the pinning, so the deques and the workers are replaced under running
+loops. Every loop checks that each of its items was visited exactly once. Meant to run under ThreadSanitizer, which
+reports any unsynchronized access; built from the abc_plusplus directory with
+
+	g++ -std=c++17 -O1 -g -fsanitize=thread -pthread -Iabc_plusplus tests/thread_pool_stress.cpp abc_plusplus/parallel.cpp abc_plusplus/numa.cpp -o thread_pool_stress
+
+and run without arguments or with the number of rounds (200 by default). Exits with 1 and a message on the first
+wrong loop.
+*/
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "parallel.h"
+
+namespace {
+	std::atomic<bool> failed{ false };
+
+	void check(bool condition, const std::string& message) {
+		if (!condition && !failed.exchange(true)) {
+			std::cerr << message << std::endl;
+		}
+	}
+
+	//a loop over n_items whose ranges run an inner loop of their own
+	void nested_loop(size_t n_items, size_t n_threads) {
+		std::vector<std::atomic<unsigned>> visits(n_items);
+		parallel_for(n_items, 7, [&visits](size_t begin, size_t end) {
+			for (size_t item = begin; item < end; ++item) {
+				std::atomic<size_t> inner{ 0 };
+				parallel_for(16, 1, [&inner](size_t inner_begin, size_t inner_end) {
+					inner += inner_end - inner_begin;
+				}, 3);
+				check(inner == 16, "an inner loop missed items");
+				++visits[item];
+			}
+		}, n_threads);
+		for (size_t item = 0; item < n_items; ++item) {
+			check(visits[item] == 1, "item " + std::to_string(item) + " was visited " + std::to_string(visits[item]) + " times");
+		}
+	}
+
+	//exceptions must reach the caller of parallel_for also while the pool is resized
+	void throwing_loop() {
+		bool caught = false;
+		try {
+			parallel_for(64, 1, [](size_t begin, size_t) {
+				if (begin == 33) {
+					throw std::runtime_error("expected");
+				}
+			}, 4);
+		}
+		catch (const std::runtime_error&) {
+			caught = true;
+		}
+		check(caught, "an exception of a loop was lost");
+	}
+}
+
+int main(int argc, char** argv) {
+	const size_t n_rounds = argc > 1 ? std::stoul(argv[1]) : 200;
+	const size_t n_callers = 4;
+
+	std::atomic<bool> done{ false };
+	std::thread resizer([&done]() {
+		for (size_t round = 0; !done; ++round) {
+			set_thread_count(1 + round % 5);
+			if (round % 7 == 0) {
+				set_thread_pinning(round % 14 == 0);
+			}
+		}
+	});
+
+	std::vector<std::thread> callers;
+	for (size_t caller_idx = 0; caller_idx < n_callers; ++caller_idx) {
+		callers.emplace_back([n_rounds, caller_idx]() {
+			for (size_t round = 0; round < n_rounds && !failed; ++round) {
+				nested_loop(50 + (round * 13 + caller_idx) % 200, 1 + (round + caller_idx) % 6);
+				if (round % 10 == caller_idx) {
+					throwing_loop();
+				}
+			}
+		});
+	}
+	for (std::thread& caller : callers) {
+		caller.join();
+	}
+	done = true;
+	resizer.join();
+
+	if (failed) {
+		return EXIT_FAILURE;
+	}
+	std::cout << n_callers << " threads ran " << n_rounds << " rounds each while the pool was resized" << std::endl;
+	return EXIT_SUCCESS;
+}
@@ -10,13 +10,12 @@ class FuzzyClustering:
         self.vectors = vectors
 
     @classmethod
-    def random(self, vectors):
-        weights = np.zeros([4, 80])
-        for i in range(80):
-            row = np.array([random_normal_01() for _ in range(4)])
-            weights[0][i], weights[1][i], weights[2][i], weights[3][i] = row / sum(row)
+    def random(self, vectors, n_clusters=4):
+        weights = np.zeros([n_clusters, len(vectors)])
+        for i in range(len(vectors)):
+            row = np.array([random_normal_01() for _ in range(n_clusters)])
+            weights.T[i] = row / sum(row)
             
-        centers = np.array([(np.random.rand(2) * 180 - 90) * random_normal_01() for _ in range(4)])
         return FuzzyClustering(weights, vectors)
     
     def compute_fitness(self):
@@ -36,7 +35,7 @@ class FuzzyClustering:
         return FuzzyClustering(new_weights, self.vectors)
 
     def params(self):
-        return (self.vectors,)
+        return (self.vectors, len(self.weights))
 
 class FuzzyClusteringNeighbors:
     @staticmethod
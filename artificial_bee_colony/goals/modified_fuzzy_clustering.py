@@ -12,11 +12,11 @@ class ModFuzzyClustering:
         self.mr = mr
 
     @classmethod
-    def random(self, vectors, f, mr):
-        weights = np.zeros([4, 80])
-        for i in range(80):
-            row = np.array([random_normal_01() for _ in range(4)])
-            weights[0][i], weights[1][i], weights[2][i], weights[3][i] = row / sum(row)
+    def random(self, vectors, f, mr, n_clusters=4):
+        weights = np.zeros([n_clusters, len(vectors)])
+        for i in range(len(vectors)):
+            row = np.array([random_normal_01() for _ in range(n_clusters)])
+            weights.T[i] = row / sum(row)
             
         return ModFuzzyClustering(weights, vectors, f, mr)
     
@@ -39,7 +39,7 @@ class ModFuzzyClustering:
         return ModFuzzyClustering(new_weights, self.vectors, self.f, self.mr)
 
     def params(self):
-        return (self.vectors, self.f, self.mr)
+        return (self.vectors, self.f, self.mr, len(self.weights))
 
 class DEFuzzyClustering:
     def __init__(self, weights, vectors, f):
@@ -0,0 +1,166 @@
+"""
+Speed and parity harness: runs the C++ colonies (the abc_plusplus module) and the Python reference colonies
+(artificial_bee_colony) on the same dataset with the same seeds, and compares the distributions of the final fitness and
+the wall-clock time per cycle.
+
+    python parity.py [--data 2D_test_data.npy] [--clusters 4] [--runs 20] [--cycles 100] [--report parity.md]
+
+The data is an n by m .npy file or whitespace-separated text; the abc_plusplus module must be compiled with VECTOR_DIM
+equal to m. Everything runs locally; the reference needs numpy and scipy.
+
+Both implementations maximize the same fitness, 1 / sum_ij u_ij |x_i - c_j| with membership-weighted means as centers, so
+the final fitness values are directly comparable. Parity is an equivalence test: the relative difference of the mean
+fitness (C++ / Python - 1) must lie within +-margin (2% by default) with the whole (1 - 2 alpha) percentile bootstrap
+confidence interval, as in the two one-sided tests (TOST) procedure. Failing to detect a difference is not evidence of
+parity, so the two-sided Mann-Whitney U test of the distributions is reported only as a diagnostic. Known differences
+between the implementations: the reference draws the initial memberships from a normal distribution truncated to
+[0, 1] instead of a uniform one, and the modified reference does not force at least one mutated gene per trial.
+"""
+import argparse
+import math
+import random
+import sys
+import time
+
+import numpy as np
+
+import abc_plusplus
+from artificial_bee_colony.colonies import BeeColony, ModBeeColony
+from artificial_bee_colony.goals import FuzzyClustering, ModFuzzyClustering
+
+
+def load_data(path):
+    if path.endswith('.npy'):
+        return np.load(path).astype(np.float64)
+    return np.loadtxt(path, dtype=np.float64, ndmin=2)
+
+
+def run_cpp(variant, data, args, seed):
+    start = time.perf_counter()
+    if variant == 'abc':
+        colony = abc_plusplus.ArtificialBeeColony(data, args.clusters, args.population, args.limit, 'uniform', None, seed)
+    else:
+        colony = abc_plusplus.ModArtificialBeeColony(data, args.clusters, args.population, args.limit, args.f, args.mr, 'uniform', None, seed)
+    colony.fit(args.cycles)
+    return colony.score(), time.perf_counter() - start
+
+
+def run_python(variant, data, args, seed):
+    random.seed(seed)
+    np.random.seed(seed % 2**32)
+    start = time.perf_counter()
+    if variant == 'abc':
+        colony = BeeColony(FuzzyClustering, data, args.clusters)
+    else:
+        colony = ModBeeColony(ModFuzzyClustering, data, args.f, args.mr, args.clusters)
+    best = colony.clusterize(args.population, args.cycles, args.limit)
+    return best.fitness, time.perf_counter() - start
+
+
+def mann_whitney_u(a, b):
+    """Two-sided Mann-Whitney U test with the normal approximation and the tie correction; returns (U, p-value)."""
+    values = np.concatenate([a, b])
+    order = np.argsort(values, kind='mergesort')
+    ranks = np.empty(len(values))
+    sorted_values = values[order]
+    tie_term = 0.0
+    start = 0
+    while start < len(values):
+        end = start
+        while end + 1 < len(values) and sorted_values[end + 1] == sorted_values[start]:
+            end += 1
+        ranks[order[start:end + 1]] = (start + end) / 2 + 1
+        ties = end - start + 1
+        tie_term += ties ** 3 - ties
+        start = end + 1
+
+    n_a, n_b = len(a), len(b)
+    n = n_a + n_b
+    u = ranks[:n_a].sum() - n_a * (n_a + 1) / 2
+    variance = n_a * n_b / 12 * ((n + 1) - tie_term / (n * (n - 1)))
+    if variance <= 0:
+        return u, 1.0
+    z = (abs(u - n_a * n_b / 2) - 0.5) / math.sqrt(variance)
+    return u, min(1.0, math.erfc(max(z, 0.0) / math.sqrt(2)))
+
+
+def bootstrap_relative_difference(a, b, alpha, n_resamples, rng):
+    """The relative difference of the means, mean(a) / mean(b) - 1, and its (1 - 2 alpha) percentile bootstrap interval."""
+    resampled_a = rng.choice(a, size=(n_resamples, len(a)), replace=True).mean(axis=1)
+    resampled_b = rng.choice(b, size=(n_resamples, len(b)), replace=True).mean(axis=1)
+    differences = resampled_a / resampled_b - 1
+    low, high = np.quantile(differences, [alpha, 1 - alpha])
+    return a.mean() / b.mean() - 1, low, high
+
+
+def summarize(values):
+    values = np.asarray(values)
+    return values.mean(), values.std(ddof=1) if len(values) > 1 else 0.0, np.median(values)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().split('\n\n')[0])
+    parser.add_argument('--data', default='2D_test_data.npy')
+    parser.add_argument('--clusters', type=int, default=4)
+    parser.add_argument('--runs', type=int, default=20)
+    parser.add_argument('--cycles', type=int, default=100)
+    parser.add_argument('--population', type=int, default=20)
+    parser.add_argument('--limit', type=int, default=100)
+    parser.add_argument('--f', type=float, default=0.8)
+    parser.add_argument('--mr', type=float, default=0.3)
+    parser.add_argument('--variants', default='abc,modabc', help='comma-separated subset of abc and modabc')
+    parser.add_argument('--seed', type=int, default=0, help='the seed of the first run; run i uses seed + i')
+    parser.add_argument('--alpha', type=float, default=0.05, help='the significance level of the tests')
+    parser.add_argument('--margin', type=float, default=0.02, help='the equivalence margin of the relative difference of the mean fitness')
+    parser.add_argument('--bootstrap', type=int, default=10000, help='the number of bootstrap resamples')
+    parser.add_argument('--report', help='also write the report to this file')
+    args = parser.parse_args()
+
+    data = load_data(args.data)
+    lines = [
+        '# C++ / Python parity report',
+        '',
+        'Dataset `%s` (%d vectors, %d dimensions), %d clusters, population %d, limit %d, %d cycles, %d runs per implementation (seeds %d to %d).'
+        % (args.data, data.shape[0], data.shape[1], args.clusters, args.population, args.limit, args.cycles, args.runs, args.seed, args.seed + args.runs - 1),
+        'Times include the initialization of the population.',
+        '',
+        '| colony | implementation | mean fitness | std | median | ms per cycle |',
+        '|---|---|---|---|---|---|',
+    ]
+    verdicts = []
+    bootstrap_rng = np.random.default_rng(args.seed)
+
+    for variant in args.variants.split(','):
+        results = {}
+        for implementation, run in (('C++', run_cpp), ('Python', run_python)):
+            fitness, seconds = [], []
+            for run_idx in range(args.runs):
+                run_fitness, run_seconds = run(variant, data, args, args.seed + run_idx)
+                fitness.append(run_fitness)
+                seconds.append(run_seconds)
+                print('%s %s run %d: fitness %.6g, %.3f s' % (variant, implementation, run_idx, run_fitness, run_seconds), file=sys.stderr)
+            results[implementation] = (np.array(fitness), np.array(seconds))
+
+            mean, std, median = summarize(fitness)
+            lines.append('| %s | %s | %.6g | %.3g | %.6g | %.4g |' % (variant, implementation, mean, std, median, 1000 * np.mean(seconds) / args.cycles))
+
+        cpp_fitness, cpp_seconds = results['C++']
+        py_fitness, py_seconds = results['Python']
+        difference, low, high = bootstrap_relative_difference(cpp_fitness, py_fitness, args.alpha, args.bootstrap, bootstrap_rng)
+        equivalent = -args.margin < low and high < args.margin
+        _, p_value = mann_whitney_u(cpp_fitness, py_fitness)
+        verdicts.append('* %s: %s; mean fitness C++ / Python - 1 = %+.2f%%, %g%% bootstrap CI [%+.2f%%, %+.2f%%] against a margin of +-%g%%; '
+            'Mann-Whitney p = %.3g; speedup %.1fx'
+            % (variant, 'equivalent' if equivalent else 'not shown equivalent', 100 * difference, 100 * (1 - 2 * args.alpha), 100 * low, 100 * high,
+               100 * args.margin, p_value, py_seconds.mean() / cpp_seconds.mean()))
+
+    lines += ['', '## Comparison', ''] + verdicts
+    report = '\n'.join(lines) + '\n'
+    print(report)
+    if args.report:
+        with open(args.report, 'w') as report_file:
+            report_file.write(report)
+
+
+if __name__ == '__main__':
+    main()